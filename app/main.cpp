@@ -0,0 +1,41 @@
+#include "mainwindow.h"
+
+#include <QApplication>
+#include <QCommandLineParser>
+
+#include <cstdio>
+
+int main(int argc, char *argv[])
+{
+    QApplication a(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption statsOption(QStringLiteral("stats"), QStringLiteral("Print run statistics of each operation to stdout."));
+    parser.addOption(statsOption);
+    QCommandLineOption memoryBudgetOption(QStringLiteral("memory-budget"),
+                                          QStringLiteral("Memory in MB an out-of-core export may use before it spills to disk."),
+                                          QStringLiteral("MB"));
+    parser.addOption(memoryBudgetOption);
+    QCommandLineOption shardsOption(QStringLiteral("shards"),
+                                    QStringLiteral("Number of files a sharded phrasebook is split into."),
+                                    QStringLiteral("count"));
+    parser.addOption(shardsOption);
+    parser.process(a);
+
+    MainWindow w;
+    w.setPrintStatistics(parser.isSet(statsOption));
+    if(parser.isSet(memoryBudgetOption)){
+        bool ok(false);
+        const qint64 megabytes = parser.value(memoryBudgetOption).toLongLong(&ok);
+        if(!ok || megabytes <= 0){
+            fputs(qPrintable(QStringLiteral("Invalid memory budget \"%1\", expected a positive number of MB.\n").arg(parser.value(memoryBudgetOption))), stderr);
+            return 1;
+        }
+        w.setMemoryBudget(megabytes * 1024 * 1024);
+    }
+    if(parser.isSet(shardsOption))
+        w.setShardCount(parser.value(shardsOption).toInt());
+    w.show();
+    return a.exec();
+}
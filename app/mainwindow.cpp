@@ -0,0 +1,528 @@
+#include "mainwindow.h"
+#include "ui_mainwindow.h"
+
+#include "merger.h"
+#include "phrasebookmaker.h"
+
+#include <QActionGroup>
+#include <QFileDialog>
+#include <QInputDialog>
+#include <QMessageBox>
+#include <QProgressBar>
+#include <QTextStream>
+#include <QThread>
+
+#include <QDebug>
+
+MainWindow::MainWindow(QWidget *parent)
+    : QMainWindow(parent)
+    , ui(new Ui::MainWindow)
+{
+    ui->setupUi(this);
+
+    setWindowTitle(tr("Phrasebook Utility Tool"));
+    qRegisterMetaType<QList<QUrl>>("QList<QUrl>");
+    qRegisterMetaType<RunStatistics>("RunStatistics");
+    qRegisterMetaType<PhrasebookMaker::Options>("PhrasebookMaker::Options");
+    qRegisterMetaType<ConflictIndex::Policy>("ConflictIndex::Policy");
+    qRegisterMetaType<Normalizer::Steps>("Normalizer::Steps");
+
+    pMaker = new PhrasebookMaker();
+    QThread *t = new QThread();
+    pMaker->moveToThread(t);
+    connect(qApp, &QCoreApplication::aboutToQuit, t, &QThread::quit);
+    connect(t, &QThread::finished, t, &QThread::deleteLater);
+    connect(t, &QThread::finished, pMaker, &PhrasebookMaker::deleteLater);
+
+    connect(pMaker, &PhrasebookMaker::error,            this, &MainWindow::displayError);
+    connect(pMaker, &PhrasebookMaker::progressMaximum,  ui->progressBar, &QProgressBar::setMaximum);
+    connect(pMaker, &PhrasebookMaker::progressValue,    ui->progressBar, &QProgressBar::setValue);
+    connect(pMaker, &PhrasebookMaker::success,          this, &MainWindow::displaySuccess);
+    connect(pMaker, &PhrasebookMaker::newlyCreatedFiles,this, &MainWindow::addCreatedFiles);
+    connect(pMaker, &PhrasebookMaker::statisticsAvailable, this, &MainWindow::displayStatistics);
+
+    connect(this, &MainWindow::optionsChanged, pMaker, &PhrasebookMaker::setOptions);
+    connect(this, &MainWindow::memoryBudgetChanged, pMaker, &PhrasebookMaker::setMemoryBudget);
+    connect(this, &MainWindow::shardCountChanged, pMaker, &PhrasebookMaker::setShardCount);
+    connect(this, &MainWindow::conflictPolicyChanged, pMaker, &PhrasebookMaker::setConflictPolicy);
+    connect(this, &MainWindow::normalizationChanged, pMaker, &PhrasebookMaker::setNormalization);
+    connect(this, &MainWindow::reportConflictsOfFiles, pMaker, &PhrasebookMaker::reportConflicts);
+    connect(this, &MainWindow::validateTranslationsOfFiles, pMaker, &PhrasebookMaker::validateTranslations);
+    connect(this, &MainWindow::analyzeFrequenciesOfFiles, pMaker, &PhrasebookMaker::analyzeFrequencies);
+    connect(this, &MainWindow::clusterSimilarSourcesOfFiles, pMaker, &PhrasebookMaker::clusterSimilarSources);
+    connect(this, &MainWindow::exportFilesToNewPhrasebooks, pMaker, &PhrasebookMaker::exportFilesToNewPhrasebooks);
+    connect(this, &MainWindow::exportFilesToSingleNewPhrasebook, pMaker, &PhrasebookMaker::exportFilesToSingleNewPhrasebook);
+    connect(this, &MainWindow::updatePhrasebookWithSources, pMaker, &PhrasebookMaker::updatePhrasebookFromFiles);
+    connect(this, &MainWindow::appendToPhrasebookWithSources, pMaker, &PhrasebookMaker::appendToPhrasebookFromFiles);
+    connect(this, &MainWindow::compactPhrasebookFile, pMaker, &PhrasebookMaker::compactPhrasebook);
+    connect(this, &MainWindow::exportPhrasebooksToLookupTables, pMaker, &PhrasebookMaker::exportPhrasebooksToLookupTables);
+    connect(this, &MainWindow::patchTsFileFromPhrasebooks, pMaker, &PhrasebookMaker::patchTsFileFromPhrasebooks);
+    connect(this, &MainWindow::patchTsFilesFromPhrasebooks, pMaker, &PhrasebookMaker::patchTsFilesFromPhrasebooks);
+    connect(this, &MainWindow::selfPatchTsFilesInPlace, pMaker, &PhrasebookMaker::selfPatchTsFiles);
+
+    t->start();
+
+    connect(ui->actionAdd_Source_File, &QAction::triggered, this, &MainWindow::addSource);
+    connect(ui->actionAdd_Targer_File, &QAction::triggered, this, &MainWindow::addTarget);
+    connect(ui->actionRemove_Selected_File, &QAction::triggered, this, &MainWindow::removeSelected);
+
+    connect(ui->actionMerge_Into_Target, &QAction::triggered, this, &MainWindow::mergeFiles);
+    connect(ui->actionPatch_Ts_File, &QAction::triggered, this, &MainWindow::patchTsFile);
+    connect(ui->actionSelf_Patch_Ts_Files, &QAction::triggered, this, &MainWindow::selfPatchTsFiles);
+
+    connect(ui->actionExport_To_Target, &QAction::triggered, this, &MainWindow::exportToSinglePhrasebook);
+    connect(ui->actionExport_To_Phrasebook, &QAction::triggered, this, &MainWindow::exportToPhrasebooks);
+    connect(ui->actionUpdate_Phrasebook, &QAction::triggered, this, &MainWindow::updatePhrasebook);
+    connect(ui->actionAppend_To_Phrasebook, &QAction::triggered, this, &MainWindow::appendToPhrasebook);
+    connect(ui->actionCompact_Phrasebook, &QAction::triggered, this, &MainWindow::compactPhrasebook);
+    connect(ui->actionExport_Lookup_Tables, &QAction::triggered, this, &MainWindow::exportLookupTables);
+    connect(ui->actionReport_Conflicts, &QAction::triggered, this, &MainWindow::reportConflicts);
+    connect(ui->actionValidate_Translations, &QAction::triggered, this, &MainWindow::validateTranslations);
+    connect(ui->actionAnalyze_Frequencies, &QAction::triggered, this, &MainWindow::analyzeFrequencies);
+    connect(ui->actionCluster_Similar_Sources, &QAction::triggered, this, &MainWindow::clusterSimilarSources);
+
+    connect(ui->actionIncremental_Export, &QAction::toggled, this, &MainWindow::updateOptions);
+    connect(ui->actionCanonical_Output, &QAction::toggled, this, &MainWindow::updateOptions);
+    connect(ui->actionOut_Of_Core_Export, &QAction::toggled, this, &MainWindow::updateOptions);
+    connect(ui->actionLocked_Update, &QAction::toggled, this, &MainWindow::updateOptions);
+    connect(ui->actionSkip_Failing_Files, &QAction::toggled, this, &MainWindow::updateOptions);
+    connect(ui->actionSharded_Output, &QAction::toggled, this, &MainWindow::updateOptions);
+
+    QActionGroup *conflictPolicies = new QActionGroup(this);
+    conflictPolicies->addAction(ui->actionConflicts_Keep_All);
+    conflictPolicies->addAction(ui->actionConflicts_First_Wins);
+    conflictPolicies->addAction(ui->actionConflicts_Majority);
+    conflictPolicies->addAction(ui->actionConflicts_Newest_File);
+    connect(conflictPolicies, &QActionGroup::triggered, this, &MainWindow::updateConflictPolicy);
+
+    for(QAction *action : ui->menuMatching->actions())
+        connect(action, &QAction::toggled, this, &MainWindow::updateNormalization);
+
+    ui->listViewSourceFiles->setSelectionMode(QAbstractItemView::ExtendedSelection);
+    ui->listViewDestinationFile->setSelectionMode(QAbstractItemView::ExtendedSelection);
+
+    ui->listViewSourceFiles->setModel(&m_sourceModel);
+    ui->listViewDestinationFile->setModel(&m_targetModel);
+}
+
+MainWindow::~MainWindow()
+{
+    delete ui;
+}
+
+void MainWindow::addSource()
+{
+    const QList<QUrl> selectedFiles = QFileDialog::getOpenFileUrls(this, tr("Select your sources"),QUrl(),tr("Translation or Phrasebook (*.ts *.qph *.qphs)") );
+
+    for(const QUrl &url : selectedFiles){
+        m_sourceModel.addEntry(url);
+    }
+}
+
+void MainWindow::addTarget()
+{
+    const QList<QUrl> urls = QFileDialog::getOpenFileUrls();
+
+    for(const QUrl &url : urls)
+        m_targetModel.addEntry(url);
+}
+
+void MainWindow::removeSelected()
+{
+    QListView *ListView = nullptr;
+
+    if(ui->listViewSourceFiles->hasFocus())
+        ListView = ui->listViewSourceFiles;
+    else if(ui->listViewDestinationFile->hasFocus())
+        ListView= ui->listViewDestinationFile;
+
+    if(!ListView || ListView->selectionModel()->selectedIndexes().size() == 0){
+        QMessageBox::warning(this, tr("Removing selection"), tr("No files selected!"));
+        return;
+    }
+
+    const QModelIndexList list = ListView->selectionModel()->selectedIndexes();
+    Model *m = qobject_cast<Model*>(ListView->model());
+    m->removeRowsByIndex(list);
+}
+
+void MainWindow::addCreatedFiles(const QList<QUrl> &files)
+{
+    for(const QUrl & url : files)
+        m_targetModel.addEntry(url,true);
+}
+
+void MainWindow::mergeFiles()
+{
+    //Sources
+    const QList<QUrl> sources = fetchSources();
+    if(sources.isEmpty())
+        return;
+
+    QUrl target;
+    QModelIndexList selectionTo = ui->listViewDestinationFile->selectionModel()->selectedIndexes();
+    if(selectionTo.isEmpty()){
+        target = QFileDialog::getOpenFileUrl();
+        if(!target.isValid())
+            return;
+    } else {
+        target = m_targetModel.data(selectionTo.first(),Model::UrlRole).toUrl();
+    }
+
+    Merger m;
+    m.setCoalesceContexts(ui->actionCoalesce_Contexts->isChecked());
+    connect(&m, &Merger::statisticsAvailable, this, &MainWindow::displayStatistics);
+    bool ok = m.Merge(sources, target);
+    if(!ok){
+        QMessageBox::critical(this, tr("Failure"), tr("Merging failed with the reason: \n%1").arg(m.error()));
+    } else {
+        QMessageBox::information(this, tr("Success"), tr("Successfully merged all *.ts files into one"));
+    }
+}
+
+void MainWindow::exportToSinglePhrasebook()
+{
+    //Sources
+    const QList<QUrl> sources = fetchSources();
+    if(sources.isEmpty())
+        return;
+
+    QModelIndexList selectionTo = ui->listViewDestinationFile->selectionModel()->selectedIndexes();
+    QUrl target;
+    if(!selectionTo.isEmpty()){
+        target = m_targetModel.data(selectionTo.first(),Model::UrlRole).toUrl();
+    } else {
+        target = QFileDialog::getSaveFileUrl(nullptr,tr("Select target file"), QString(),tr("Phrasebook (*.qph)"));
+    }
+    if(!target.isValid())
+        return;
+
+    QString sourceLanguage = requestSourceLanguage();
+
+    if(!sourceLanguage.isEmpty())
+        emit exportFilesToSingleNewPhrasebook(sources,target, sourceLanguage);
+}
+
+void MainWindow::exportToPhrasebooks()
+{
+    //Sources
+    const QList<QUrl> sources = fetchSources();
+    if(sources.isEmpty())
+        return;
+
+    PhrasebookMaker pMaker;
+    connect(&pMaker, &PhrasebookMaker::error, this, &MainWindow::displayError);
+    connect(&pMaker, &PhrasebookMaker::progressMaximum, ui->progressBar, &QProgressBar::setMaximum);
+    connect(&pMaker, &PhrasebookMaker::progressValue, ui->progressBar, &QProgressBar::setValue);
+
+    QString srcLang = requestSourceLanguage();
+
+    if(!srcLang.isEmpty())
+        emit exportFilesToNewPhrasebooks(sources, srcLang);
+}
+
+void MainWindow::updatePhrasebook()
+{
+    QList<QUrl> sources;
+    QUrl target;
+    QString sourceLanguage;
+    if(prepareUpdate(sources, target, sourceLanguage))
+        emit updatePhrasebookWithSources(sources,target,sourceLanguage);
+}
+
+void MainWindow::appendToPhrasebook()
+{
+    QList<QUrl> sources;
+    QUrl target;
+    QString sourceLanguage;
+    if(prepareUpdate(sources, target, sourceLanguage))
+        emit appendToPhrasebookWithSources(sources,target,sourceLanguage);
+}
+
+void MainWindow::compactPhrasebook()
+{
+    QModelIndexList selectionTo = ui->listViewDestinationFile->selectionModel()->selectedIndexes();
+    QUrl target;
+    if(!selectionTo.isEmpty()){
+        target = m_targetModel.data(selectionTo.first(),Model::UrlRole).toUrl();
+    } else {
+        target = QFileDialog::getOpenFileUrl(nullptr,tr("Select phrasebook"), QUrl(),tr("Phrasebook (*.qph *.qphs)"));
+    }
+    if(!target.isValid()){
+        QMessageBox::information(nullptr, tr("Target phrasebook"), tr("Please select a phrasebook to compact"));
+        return;
+    }
+
+    emit compactPhrasebookFile(target);
+}
+
+void MainWindow::exportLookupTables()
+{
+    //Sources
+    const QList<QUrl> sources = fetchSources();
+    if(sources.isEmpty())
+        return;
+
+    emit exportPhrasebooksToLookupTables(sources);
+}
+
+void MainWindow::reportConflicts()
+{
+    //Sources
+    const QList<QUrl> sources = fetchSources();
+    if(sources.isEmpty())
+        return;
+
+    const QUrl report = QFileDialog::getSaveFileUrl(nullptr,tr("Select report file"), QUrl(),tr("Report (*.json)"));
+    if(!report.isValid())
+        return;
+
+    emit reportConflictsOfFiles(sources, report);
+}
+
+void MainWindow::validateTranslations()
+{
+    //Sources
+    const QList<QUrl> sources = fetchSources();
+    if(sources.isEmpty())
+        return;
+
+    const QUrl report = QFileDialog::getSaveFileUrl(nullptr,tr("Select report file"), QUrl(),tr("Report (*.json)"));
+    if(!report.isValid())
+        return;
+
+    emit validateTranslationsOfFiles(sources, report);
+}
+
+void MainWindow::analyzeFrequencies()
+{
+    //Sources
+    const QList<QUrl> sources = fetchSources();
+    if(sources.isEmpty())
+        return;
+
+    const QUrl report = QFileDialog::getSaveFileUrl(nullptr,tr("Select report file"), QUrl(),tr("Report (*.json)"));
+    if(!report.isValid())
+        return;
+
+    emit analyzeFrequenciesOfFiles(sources, report);
+}
+
+void MainWindow::clusterSimilarSources()
+{
+    //Sources
+    const QList<QUrl> sources = fetchSources();
+    if(sources.isEmpty())
+        return;
+
+    const QUrl report = QFileDialog::getSaveFileUrl(nullptr,tr("Select report file"), QUrl(),tr("Report (*.json)"));
+    if(!report.isValid())
+        return;
+
+    emit clusterSimilarSourcesOfFiles(sources, report);
+}
+
+bool MainWindow::prepareUpdate(QList<QUrl> &sources, QUrl &target, QString &sourceLanguage)
+{
+    //Sources
+    sources = fetchSources();
+    if(sources.isEmpty())
+        return false;
+
+    //Target
+    QModelIndexList selectionTo = ui->listViewDestinationFile->selectionModel()->selectedIndexes();
+    if(!selectionTo.isEmpty()){
+        target = m_targetModel.data(selectionTo.first(),Model::UrlRole).toUrl();
+    } else {
+        target = QFileDialog::getSaveFileUrl(nullptr,tr("Select target file"), QString(),tr("Phrasebook (*.qph)"));
+
+        //add it to listview, in case it's not already on the target list
+        if(target.isValid())
+            addCreatedFiles(QList<QUrl>{target});
+    }
+    if(!target.isValid()){
+        QMessageBox::information(nullptr, tr("Target phrasebook"), tr("Please select a target phrasebook to update"));
+        return false;
+    }
+
+    sourceLanguage = requestSourceLanguage();
+
+    if(sourceLanguage.isEmpty()){
+        QMessageBox::information(nullptr, tr("Source language"), tr("Please specify the source language"));
+        return false;
+    }
+    return true;
+}
+
+void MainWindow::patchTsFile()
+{
+    //Sources
+    const QList<QUrl> sources = fetchSources();
+    if(sources.isEmpty())
+        return;
+
+    //Target
+    QModelIndexList selectionTo = ui->listViewDestinationFile->selectionModel()->selectedIndexes();
+    if(selectionTo.size() > 1){
+        //Several targets are patched in one run, the phrasebooks are only parsed once
+        QList<QUrl> targets;
+        for(const QModelIndex &index : selectionTo)
+            targets << m_targetModel.data(index, Model::UrlRole).toUrl();
+        emit patchTsFilesFromPhrasebooks(sources, targets);
+        return;
+    }
+
+    QUrl target;
+    if(!selectionTo.isEmpty()){
+        target = m_targetModel.data(selectionTo.first(),Model::UrlRole).toUrl();
+    } else {
+        target = QFileDialog::getSaveFileUrl(nullptr,tr("Select target file"), QString(),tr("Translation file (*.ts)"));
+    }
+    if(!target.isValid()){
+        QMessageBox::information(nullptr, tr("Translation file"), tr("Please select a translation file to update"));
+        return;
+    } else {
+        //add in cause it's not in target list
+        addCreatedFiles(QList<QUrl>{target});
+    }
+
+    emit patchTsFileFromPhrasebooks(sources,target);
+}
+
+void MainWindow::selfPatchTsFiles()
+{
+    //Targets, patched in place
+    QList<QUrl> targets;
+    const QModelIndexList selectionTo = ui->listViewDestinationFile->selectionModel()->selectedIndexes();
+    for(const QModelIndex &index : selectionTo)
+        targets << m_targetModel.data(index, Model::UrlRole).toUrl();
+
+    if(targets.isEmpty())
+        targets = QFileDialog::getOpenFileUrls(nullptr, tr("Select translation files"), QUrl(), tr("Translation file (*.ts)"));
+    if(targets.isEmpty()){
+        QMessageBox::information(nullptr, tr("Translation file"), tr("Please select a translation file to update"));
+        return;
+    }
+
+    emit selfPatchTsFilesInPlace(targets);
+}
+
+void MainWindow::displayError(const QString &error)
+{
+    QMessageBox::warning(this, "Error", error);
+}
+
+void MainWindow::displaySuccess()
+{
+    QMessageBox::information(this, tr("Success"), tr("Export was successful"));
+}
+
+void MainWindow::displayStatistics(const RunStatistics &statistics)
+{
+    ui->statusbar->showMessage(tr("%1 phrases, %2 duplicates dropped, %3 ms")
+                               .arg(statistics.uniquePhrases)
+                               .arg(statistics.duplicatesDropped)
+                               .arg(statistics.wallTime));
+
+    if(m_printStatistics){
+        QTextStream out(stdout);
+        out << statistics.toString() << endl << endl;
+    }
+}
+
+void MainWindow::updateOptions()
+{
+    PhrasebookMaker::Options options;
+    if(ui->actionIncremental_Export->isChecked())
+        options |= PhrasebookMaker::IncrementalExport;
+    if(ui->actionCanonical_Output->isChecked())
+        options |= PhrasebookMaker::CanonicalOutput;
+    if(ui->actionOut_Of_Core_Export->isChecked())
+        options |= PhrasebookMaker::OutOfCoreExport;
+    if(ui->actionLocked_Update->isChecked())
+        options |= PhrasebookMaker::LockedUpdate;
+    if(ui->actionSkip_Failing_Files->isChecked())
+        options |= PhrasebookMaker::SkipFailingFiles;
+    if(ui->actionSharded_Output->isChecked())
+        options |= PhrasebookMaker::ShardedOutput;
+
+    emit optionsChanged(options);
+}
+
+void MainWindow::updateConflictPolicy()
+{
+    ConflictIndex::Policy policy(ConflictIndex::KeepAll);
+    if(ui->actionConflicts_First_Wins->isChecked())
+        policy = ConflictIndex::FirstWins;
+    else if(ui->actionConflicts_Majority->isChecked())
+        policy = ConflictIndex::Majority;
+    else if(ui->actionConflicts_Newest_File->isChecked())
+        policy = ConflictIndex::NewestFile;
+
+    emit conflictPolicyChanged(policy);
+}
+
+void MainWindow::updateNormalization()
+{
+    Normalizer::Steps normalization;
+    if(ui->actionMatching_Strip_Accelerators->isChecked())
+        normalization |= Normalizer::StripAccelerators;
+    if(ui->actionMatching_Fold_Whitespace->isChecked())
+        normalization |= Normalizer::FoldWhitespace;
+    if(ui->actionMatching_Strip_Trailing_Punctuation->isChecked())
+        normalization |= Normalizer::StripTrailingPunctuation;
+    if(ui->actionMatching_Fold_Case->isChecked())
+        normalization |= Normalizer::FoldCase;
+
+    emit normalizationChanged(normalization);
+}
+
+QString MainWindow::requestSourceLanguage()
+{
+    QStringList languages;
+    for(int i(2); i < static_cast<int>(QLocale::LastLanguage); i++) {
+        languages.append( QLocale::languageToString(static_cast<QLocale::Language>(i)));
+    }
+
+    QStringList refLanguages = languages;
+    std::sort(languages.begin(), languages.end());
+
+    int index = languages.indexOf(QLocale::languageToString(static_cast<QLocale::Language>(QLocale::system().language())));
+    QString selection = QInputDialog::getItem(nullptr,tr("Missing information"),tr("Select source language"),languages,index,false);
+
+    if(selection.isNull() || selection.isEmpty()){
+        displayError(tr("No source language selected"));
+        return QString();
+    }
+
+    index = refLanguages.indexOf(selection);
+    if(index < 0){
+        displayError(tr("Invalid language"));
+        return QString();
+    }
+
+    return QLocale(static_cast<QLocale::Language>(index + 2)).name();
+}
+
+QList<QUrl> MainWindow::fetchSources()
+{
+    QList<QUrl> sources;
+
+    QModelIndexList selection = ui->listViewSourceFiles->selectionModel()->selectedIndexes();
+    if(selection.isEmpty()){
+        //Assume all Files
+        ui->listViewSourceFiles->selectAll();
+        selection = ui->listViewSourceFiles->selectionModel()->selectedIndexes();
+
+        if(selection.isEmpty()){
+            QMessageBox::warning(this, tr("No files selected"), tr("Please select at least one source file"));
+            return sources;
+        }
+    }
+
+    for(const QModelIndex &index : selection){
+        sources.append(m_sourceModel.data(index, Model::UrlRole).toUrl());
+    }
+    return sources;
+}
+
@@ -0,0 +1,90 @@
+#ifndef MAINWINDOW_H
+#define MAINWINDOW_H
+
+#include <QMainWindow>
+#include "model.h"
+#include "phrasebookmaker.h"
+#include "runstatistics.h"
+
+QT_BEGIN_NAMESPACE
+namespace Ui { class MainWindow; }
+QT_END_NAMESPACE
+
+class MainWindow : public QMainWindow
+{
+    Q_OBJECT
+
+public:
+    MainWindow(QWidget *parent = nullptr);
+    ~MainWindow();
+
+    inline void setPrintStatistics(bool print){m_printStatistics = print;}
+    inline void setMemoryBudget(qint64 bytes){emit memoryBudgetChanged(bytes);}
+    inline void setShardCount(int count){emit shardCountChanged(count);}
+
+private slots:
+    void addSource();
+    void addTarget();
+    void removeSelected();
+
+    void addCreatedFiles(const QList<QUrl> &files);
+
+    void mergeFiles();
+    void exportToSinglePhrasebook();
+    void exportToPhrasebooks();
+    void updatePhrasebook();
+    void appendToPhrasebook();
+    void compactPhrasebook();
+    void exportLookupTables();
+    void reportConflicts();
+    void validateTranslations();
+    void analyzeFrequencies();
+    void clusterSimilarSources();
+    void patchTsFile();
+    void selfPatchTsFiles();
+
+    void displayError(const QString &error);
+    void displaySuccess();
+    void displayStatistics(const RunStatistics &statistics);
+
+    void updateOptions();
+    void updateConflictPolicy();
+    void updateNormalization();
+
+    QString requestSourceLanguage();
+signals:
+    void optionsChanged(PhrasebookMaker::Options options);
+    void memoryBudgetChanged(qint64 bytes);
+    void shardCountChanged(int count);
+    void conflictPolicyChanged(ConflictIndex::Policy policy);
+    void normalizationChanged(Normalizer::Steps normalization);
+    void reportConflictsOfFiles(const QList<QUrl> &sources, const QUrl &report);
+    void validateTranslationsOfFiles(const QList<QUrl> &sources, const QUrl &report);
+    void analyzeFrequenciesOfFiles(const QList<QUrl> &sources, const QUrl &report);
+    void clusterSimilarSourcesOfFiles(const QList<QUrl> &sources, const QUrl &report);
+    void exportFilesToNewPhrasebooks(const QList<QUrl> &sources, const QString &srcLang);
+    void exportFilesToSingleNewPhrasebook(const QList<QUrl> &sources, const QUrl &destination, const QString &sourceLanguage);
+    void updatePhrasebookWithSources(const QList<QUrl> &sourcesTs, const QUrl &targetPhrasebook, const QString &sourceLanguage);
+    void appendToPhrasebookWithSources(const QList<QUrl> &sourcesTs, const QUrl &targetPhrasebook, const QString &sourceLanguage);
+    void compactPhrasebookFile(const QUrl &phrasebook);
+    void exportPhrasebooksToLookupTables(const QList<QUrl> &phrasebooks);
+    void patchTsFileFromPhrasebooks(const QList<QUrl> &sourcesQph, const QUrl &targetTsFile);
+    void patchTsFilesFromPhrasebooks(const QList<QUrl> &sourcesQph, const QList<QUrl> &targetTsFiles);
+    void selfPatchTsFilesInPlace(const QList<QUrl> &tsFiles);
+
+private:
+    QList<QUrl> fetchSources();
+    bool prepareUpdate(QList<QUrl> &sources, QUrl &target, QString &sourceLanguage);
+
+private:
+    Ui::MainWindow *ui;
+
+
+    Model m_sourceModel;
+    Model m_targetModel;
+    PhrasebookMaker *pMaker;
+
+    bool m_printStatistics = false;
+
+};
+#endif // MAINWINDOW_H
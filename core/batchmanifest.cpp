@@ -0,0 +1,197 @@
+#include "batchmanifest.h"
+#include "exportmanifest.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+const int BatchManifestVersion(1);
+
+namespace {
+QString statusName(BatchManifest::Status status)
+{
+    switch (status) {
+    case BatchManifest::Done: return QStringLiteral("done");
+    case BatchManifest::Failed: return QStringLiteral("failed");
+    default: return QStringLiteral("pending");
+    }
+}
+
+BatchManifest::Status statusFromName(const QString &name)
+{
+    if(name == QLatin1String("done"))
+        return BatchManifest::Done;
+    if(name == QLatin1String("failed"))
+        return BatchManifest::Failed;
+    return BatchManifest::Pending;
+}
+}
+
+BatchManifest::BatchManifest(const QString &operation, const QStringList &inputs, const QString &settings)
+    : m_operation(operation), m_settings(settings), m_inputs(inputs)
+{
+    //Same batch -> same checkpoint, independent of the order the files were selected in
+    QStringList sortedInputs = inputs;
+    sortedInputs.sort();
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(operation.toUtf8());
+    hash.addData(settings.toUtf8());
+    for(const QString &input : qAsConst(sortedInputs))
+        hash.addData(input.toUtf8());
+
+    const QString directory = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QStringLiteral("/batches");
+    m_fileName = directory + QLatin1Char('/') + QString::fromLatin1(hash.result().toHex().left(16)) + QStringLiteral(".json");
+}
+
+bool BatchManifest::load()
+{
+    QFile file(m_fileName);
+    if(!file.open(QIODevice::ReadOnly))
+        return false;
+
+    const QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+    if(root.value("version").toInt() != BatchManifestVersion || root.value("operation").toString() != m_operation
+            || root.value("settings").toString() != m_settings)
+        return false;
+
+    const auto fileState = [](const QJsonObject &object){
+        FileState state;
+        state.path = object.value("path").toString();
+        state.size = static_cast<qint64>(object.value("size").toDouble(-1));
+        state.modified = static_cast<qint64>(object.value("modified").toDouble(-1));
+        state.hash = QByteArray::fromHex(object.value("hash").toString().toLatin1());
+        return state;
+    };
+
+    m_items.clear();
+    const QJsonArray items = root.value("items").toArray();
+    for(const QJsonValue &value : items){
+        const QJsonObject object = value.toObject();
+        Item item;
+        item.status = statusFromName(object.value("status").toString());
+        item.input = fileState(object.value("input").toObject());
+        item.output = fileState(object.value("output").toObject());
+        item.error = object.value("error").toString();
+        if(m_inputs.contains(item.input.path))
+            m_items.insert(item.input.path, item);
+    }
+    return true;
+}
+
+bool BatchManifest::save() const
+{
+    const auto fileState = [](const FileState &state){
+        QJsonObject object;
+        object.insert("path", state.path);
+        object.insert("size", static_cast<double>(state.size));
+        object.insert("modified", static_cast<double>(state.modified));
+        object.insert("hash", QString::fromLatin1(state.hash.toHex()));
+        return object;
+    };
+
+    //In the order of the inputs, so the file reads like the batch
+    QJsonArray items;
+    for(const QString &input : m_inputs){
+        Item item = m_items.value(input);
+        item.input.path = input;
+
+        QJsonObject object;
+        object.insert("status", statusName(item.status));
+        object.insert("input", fileState(item.input));
+        if(item.status == Done)
+            object.insert("output", fileState(item.output));
+        if(item.status == Failed)
+            object.insert("error", item.error);
+        items.append(object);
+    }
+
+    QJsonObject root;
+    root.insert("version", BatchManifestVersion);
+    root.insert("operation", m_operation);
+    root.insert("settings", m_settings);
+    root.insert("items", items);
+
+    QDir().mkpath(QFileInfo(m_fileName).absolutePath());
+    QSaveFile file(m_fileName);
+    if(!file.open(QIODevice::WriteOnly))
+        return false;
+    file.write(QJsonDocument(root).toJson());
+    return file.commit();
+}
+
+void BatchManifest::remove() const
+{
+    QFile::remove(m_fileName);
+}
+
+BatchManifest::Status BatchManifest::status(const QString &input) const
+{
+    return m_items.value(input).status;
+}
+
+bool BatchManifest::isDone(const QString &input) const
+{
+    const auto item = m_items.constFind(input);
+    if(item == m_items.constEnd() || item.value().status != Done)
+        return false;
+    return item.value().input.matches() && item.value().output.matches();
+}
+
+int BatchManifest::doneCount() const
+{
+    int done(0);
+    for(const QString &input : m_inputs){
+        if(isDone(input))
+            done++;
+    }
+    return done;
+}
+
+void BatchManifest::markDone(const QString &input, const QString &output)
+{
+    Item item;
+    item.status = Done;
+    item.input = FileState::of(input);
+    item.output = input == output ? item.input : FileState::of(output);
+    m_items.insert(input, item);
+}
+
+void BatchManifest::markFailed(const QString &input, const QString &errorMessage)
+{
+    Item item;
+    item.status = Failed;
+    item.input.path = input;
+    item.error = errorMessage;
+    m_items.insert(input, item);
+}
+
+BatchManifest::FileState BatchManifest::FileState::of(const QString &path)
+{
+    const QFileInfo info(path);
+    FileState state;
+    state.path = path;
+    state.size = info.size();
+    state.modified = info.lastModified().toMSecsSinceEpoch();
+    state.hash = ExportManifest::fileHash(path);
+    return state;
+}
+
+bool BatchManifest::FileState::matches() const
+{
+    const QFileInfo info(path);
+    if(!info.exists() || info.size() != size)
+        return false;
+
+    //Same size and timestamp -> trust it, otherwise compare the content
+    if(info.lastModified().toMSecsSinceEpoch() == modified)
+        return true;
+    return !hash.isEmpty() && ExportManifest::fileHash(path) == hash;
+}
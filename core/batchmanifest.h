@@ -0,0 +1,71 @@
+#ifndef BATCHMANIFEST_H
+#define BATCHMANIFEST_H
+
+#include "phrasebookcore_global.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+
+//Checkpoint of a batch operation over many files, so an interrupted or partly failed run resumes
+//with the first incomplete file. Identified by the operation, its inputs and settings and stored as
+//<cache location>/batches/<id>.json. The manifest is removed once every file was processed
+class PHRASEBOOKCORE_EXPORT BatchManifest
+{
+public:
+    enum Status {
+        Pending,
+        Done,
+        Failed
+    };
+
+    BatchManifest(const QString &operation, const QStringList &inputs, const QString &settings);
+
+    inline QString fileName() const {return m_fileName;}
+
+    //False if there is no checkpoint of the same batch
+    bool load();
+    bool save() const;
+    void remove() const;
+
+    Status status(const QString &input) const;
+
+    //Done, and neither the input nor the output changed since
+    bool isDone(const QString &input) const;
+    int doneCount() const;
+
+    //Records the state of both files after the item was processed, input and output may be the same file
+    void markDone(const QString &input, const QString &output);
+    void markFailed(const QString &input, const QString &errorMessage);
+
+private:
+    struct FileState
+    {
+        QString path;
+        qint64 size = -1;
+        qint64 modified = -1;
+        QByteArray hash;
+
+        static FileState of(const QString &path);
+        bool matches() const;
+    };
+
+    struct Item
+    {
+        Status status = Pending;
+        FileState input;
+        FileState output;
+        QString error;
+    };
+
+private:
+    QString m_operation;
+    QString m_settings;
+    QString m_fileName;
+
+    QStringList m_inputs;
+    QHash<QString, Item> m_items;
+};
+
+#endif // BATCHMANIFEST_H
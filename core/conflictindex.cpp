@@ -0,0 +1,196 @@
+#include "conflictindex.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+
+ConflictIndex::ConflictIndex(Normalizer::Steps normalization) : m_normalization(normalization)
+{
+
+}
+
+void ConflictIndex::reserve(int size)
+{
+    m_occurrences.reserve(size);
+}
+
+void ConflictIndex::clear()
+{
+    m_occurrences.clear();
+    m_order = 0;
+}
+
+void ConflictIndex::add(const Phrase &phrase, const QString &file, qint64 fileModified)
+{
+    if(!phrase.hasTranslation())
+        return;
+
+    Occurrence occurrence;
+    occurrence.source = phrase.source();
+    occurrence.target = phrase.target();
+    occurrence.file = file;
+    occurrence.context = phrase.definition();
+    occurrence.fileModified = fileModified;
+    occurrence.order = m_order++;
+
+    m_occurrences[phrase.matchKey(m_normalization)].append(occurrence);
+}
+
+QString ConflictIndex::key(const QString &source) const
+{
+    if(m_normalization == Normalizer::NoNormalization)
+        return source;
+    return Normalizer::normalized(source, m_normalization);
+}
+
+QStringList ConflictIndex::conflictingSources() const
+{
+    QStringList sources;
+    for(auto it = m_occurrences.constBegin(); it != m_occurrences.constEnd(); ++it){
+        if(isConflictingKey(it.key()))
+            sources << it.key();
+    }
+    sources.sort();
+    return sources;
+}
+
+bool ConflictIndex::isConflicting(const QString &source) const
+{
+    return isConflictingKey(key(source));
+}
+
+bool ConflictIndex::isConflictingKey(const QString &key) const
+{
+    const auto it = m_occurrences.constFind(key);
+    if(it == m_occurrences.constEnd())
+        return false;
+
+    const QVector<Occurrence> &occurrences = it.value();
+    for(const Occurrence &occurrence : occurrences){
+        if(occurrence.target != occurrences.first().target)
+            return true;
+    }
+    return false;
+}
+
+QString ConflictIndex::resolvedTarget(const QString &source, Policy policy) const
+{
+    return resolvedTargetOfKey(key(source), policy);
+}
+
+QString ConflictIndex::resolvedTargetOfKey(const QString &key, Policy policy) const
+{
+    const auto it = m_occurrences.constFind(key);
+    if(policy == KeepAll || it == m_occurrences.constEnd() || it.value().isEmpty())
+        return QString();
+
+    const QVector<Occurrence> &occurrences = it.value();
+    switch (policy) {
+    case FirstWins:
+        return occurrences.first().target;
+    case Majority:{
+        QHash<QString, int> counts;
+        QString winner;
+        int winnerCount(0);
+        //Occurrences are in insertion order, so ties stay with the first seen target
+        for(const Occurrence &occurrence : occurrences){
+            const int count = ++counts[occurrence.target];
+            if(count > winnerCount){
+                winner = occurrence.target;
+                winnerCount = count;
+            }
+        }
+        return winner;
+    }
+    case NewestFile:{
+        const Occurrence *newest = &occurrences.first();
+        for(const Occurrence &occurrence : occurrences){
+            if(occurrence.fileModified > newest->fileModified)
+                newest = &occurrence;
+        }
+        return newest->target;
+    }
+    case KeepAll:
+        break;
+    }
+    return QString();
+}
+
+QVector<Phrase> ConflictIndex::resolve(const QVector<Phrase> &phrases, Policy policy, int *dropped) const
+{
+    if(dropped)
+        *dropped = 0;
+    if(policy == KeepAll)
+        return phrases;
+
+    //Decide each conflicting source only once
+    QHash<QString, QString> decisions;
+
+    QVector<Phrase> resolved;
+    resolved.reserve(phrases.size());
+    for(const Phrase &phrase : phrases){
+        const QString key = phrase.matchKey(m_normalization);
+        if(phrase.hasTranslation() && isConflictingKey(key)){
+            auto decision = decisions.constFind(key);
+            if(decision == decisions.constEnd())
+                decision = decisions.insert(key, resolvedTargetOfKey(key, policy));
+
+            if(decision.value() != phrase.target()){
+                if(dropped)
+                    (*dropped)++;
+                continue;
+            }
+        }
+        resolved.append(phrase);
+    }
+    return resolved;
+}
+
+bool ConflictIndex::writeReport(const QString &fileName) const
+{
+    const QStringList sources = conflictingSources();
+
+    QJsonArray conflicts;
+    for(const QString &source : sources){
+        //Group occurrences by target, in first seen order
+        QStringList targets;
+        QHash<QString, QJsonArray> occurrencesByTarget;
+        for(const Occurrence &occurrence : m_occurrences.value(source)){
+            if(!occurrencesByTarget.contains(occurrence.target))
+                targets << occurrence.target;
+
+            QJsonObject entry;
+            entry.insert("source", occurrence.source);
+            entry.insert("file", occurrence.file);
+            entry.insert("context", occurrence.context);
+            occurrencesByTarget[occurrence.target].append(entry);
+        }
+
+        QJsonArray variants;
+        for(const QString &target : qAsConst(targets)){
+            const QJsonArray occurrences = occurrencesByTarget.value(target);
+            QJsonObject variant;
+            variant.insert("target", target);
+            variant.insert("count", occurrences.size());
+            variant.insert("occurrences", occurrences);
+            variants.append(variant);
+        }
+
+        QJsonObject conflict;
+        conflict.insert("source", source);
+        conflict.insert("targets", variants);
+        conflicts.append(conflict);
+    }
+
+    QJsonObject root;
+    root.insert("sources", m_occurrences.size());
+    root.insert("conflictingSources", sources.size());
+    root.insert("conflicts", conflicts);
+
+    QSaveFile file(fileName);
+    if(!file.open(QIODevice::WriteOnly))
+        return false;
+    file.write(QJsonDocument(root).toJson());
+    return file.commit();
+}
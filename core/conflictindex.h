@@ -0,0 +1,73 @@
+#ifndef CONFLICTINDEX_H
+#define CONFLICTINDEX_H
+
+#include "phrasebookcore_global.h"
+#include "normalizer.h"
+#include "phrase.h"
+
+#include <QHash>
+#include <QMetaType>
+#include <QStringList>
+#include <QVector>
+
+//Source keyed multimap of every translation found in a corpus, used to find
+//sources that are translated differently across files and contexts.
+//With normalization, sources are keyed by their matching key like in PhraseCollection
+class PHRASEBOOKCORE_EXPORT ConflictIndex
+{
+public:
+    enum Policy {
+        KeepAll,    //Keep every translation, as before
+        FirstWins,  //Keep the translation that was seen first
+        Majority,   //Keep the most common translation, ties go to the first seen
+        NewestFile  //Keep the translation from the most recently modified file
+    };
+
+    struct Occurrence
+    {
+        QString source;     //As written, may differ from the key with normalization
+        QString target;
+        QString file;
+        QString context;
+        qint64 fileModified = 0;
+        int order = 0;
+    };
+
+    explicit ConflictIndex(Normalizer::Steps normalization = Normalizer::NoNormalization);
+
+    void reserve(int size);
+    void clear();
+
+    //Phrases without translation are ignored
+    void add(const Phrase &phrase, const QString &file, qint64 fileModified);
+
+    inline int sourceCount() const {return m_occurrences.size();}
+
+    //Keys of the sources with more than one distinct target
+    QStringList conflictingSources() const;
+    bool isConflicting(const QString &source) const;
+
+    inline QVector<Occurrence> occurrences(const QString &source) const {return m_occurrences.value(key(source));}
+
+    //Target to keep for a source, empty for KeepAll or unknown sources
+    QString resolvedTarget(const QString &source, Policy policy) const;
+
+    //Drops all phrases of conflicting sources whose target was not chosen by the policy
+    QVector<Phrase> resolve(const QVector<Phrase> &phrases, Policy policy, int *dropped = nullptr) const;
+
+    bool writeReport(const QString &fileName) const;
+
+private:
+    QString key(const QString &source) const;
+    bool isConflictingKey(const QString &key) const;
+    QString resolvedTargetOfKey(const QString &key, Policy policy) const;
+
+private:
+    Normalizer::Steps m_normalization;
+    QHash<QString, QVector<Occurrence>> m_occurrences;
+    int m_order = 0;
+};
+
+Q_DECLARE_METATYPE(ConflictIndex::Policy)
+
+#endif // CONFLICTINDEX_H
@@ -0,0 +1,65 @@
+TEMPLATE = lib
+TARGET = phrasebookcore
+
+# Widget free, so the GUI, command line tools and services can all link it
+QT = core concurrent
+
+CONFIG += c++11
+
+phrasebookcore_shared {
+    DEFINES += PHRASEBOOKCORE_SHARED PHRASEBOOKCORE_LIBRARY
+} else {
+    CONFIG += staticlib
+}
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+SOURCES += \
+    batchmanifest.cpp \
+    conflictindex.cpp \
+    exportmanifest.cpp \
+    externaldeduplicator.cpp \
+    frequencyanalyzer.cpp \
+    lazyphrase.cpp \
+    merger.cpp \
+    normalizer.cpp \
+    phrase.cpp \
+    phrasebookfilter.cpp \
+    phrasebookindex.cpp \
+    phrasecollection.cpp \
+    phrasebookmaker.cpp \
+    phrasebookshards.cpp \
+    phrasetablewriter.cpp \
+    phrasevalidator.cpp \
+    progressreporter.cpp \
+    runstatistics.cpp \
+    sourceclusterer.cpp \
+    xmlcodec.cpp
+
+HEADERS += \
+    batchmanifest.h \
+    conflictindex.h \
+    exportmanifest.h \
+    externaldeduplicator.h \
+    frequencyanalyzer.h \
+    lazyphrase.h \
+    merger.h \
+    normalizer.h \
+    parallelsort.h \
+    phrase.h \
+    phrasebookcore.h \
+    phrasebookcore_global.h \
+    phrasebookfilter.h \
+    phrasebookindex.h \
+    phrasecollection.h \
+    phrasebookmaker.h \
+    phrasebookshards.h \
+    phrasetable.h \
+    phrasetablewriter.h \
+    phrasevalidator.h \
+    progressreporter.h \
+    runstatistics.h \
+    sourceclusterer.h \
+    xmlcodec.h
+
+win32: LIBS += -lpsapi
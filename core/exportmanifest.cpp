@@ -0,0 +1,201 @@
+#include "exportmanifest.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+
+const quint32 ContextCacheMagic(0x50424343); //PBCC
+const quint32 ContextCacheVersion(3);
+const int ManifestVersion(3);
+
+ExportManifest::ExportManifest(const QString &outputFile)
+    : m_outputFile(outputFile)
+{
+
+}
+
+QString ExportManifest::manifestFileName(const QString &outputFile)
+{
+    return outputFile + QStringLiteral(".manifest");
+}
+
+QString ExportManifest::cacheFileName(const QString &outputFile)
+{
+    return outputFile + QStringLiteral(".cache");
+}
+
+QByteArray ExportManifest::fileHash(const QString &fileName)
+{
+    QFile file(fileName);
+    if(!file.open(QIODevice::ReadOnly))
+        return QByteArray();
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    if(!hash.addData(&file))
+        return QByteArray();
+    return hash.result();
+}
+
+QByteArray ExportManifest::contextHash(const QString &definition, const QString &context)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(reinterpret_cast<const char *>(definition.constData()), definition.size() * int(sizeof(QChar)));
+    hash.addData(reinterpret_cast<const char *>(context.constData()), context.size() * int(sizeof(QChar)));
+    return hash.result();
+}
+
+bool ExportManifest::load()
+{
+    QFile file(manifestFileName(m_outputFile));
+    if(!file.open(QIODevice::ReadOnly))
+        return false;
+
+    const QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+    if(root.value("version").toInt() != ManifestVersion)
+        return false;
+
+    m_settings = root.value("settings").toString();
+    const QJsonObject output = root.value("output").toObject();
+    m_outputSize = static_cast<qint64>(output.value("size").toDouble(-1));
+    m_outputModified = static_cast<qint64>(output.value("modified").toDouble(-1));
+
+    m_inputs.clear();
+    const QJsonArray inputs = root.value("inputs").toArray();
+    for(const QJsonValue &value : inputs){
+        const QJsonObject input = value.toObject();
+        Entry entry;
+        entry.path = input.value("path").toString();
+        entry.size = static_cast<qint64>(input.value("size").toDouble(-1));
+        entry.modified = static_cast<qint64>(input.value("modified").toDouble(-1));
+        entry.hash = QByteArray::fromHex(input.value("hash").toString().toLatin1());
+        m_inputs.append(entry);
+    }
+    return true;
+}
+
+bool ExportManifest::save() const
+{
+    QJsonArray inputs;
+    for(const Entry &entry : m_inputs){
+        QJsonObject input;
+        input.insert("path", entry.path);
+        input.insert("size", static_cast<double>(entry.size));
+        input.insert("modified", static_cast<double>(entry.modified));
+        input.insert("hash", QString::fromLatin1(entry.hash.toHex()));
+        inputs.append(input);
+    }
+
+    QJsonObject output;
+    output.insert("size", static_cast<double>(m_outputSize));
+    output.insert("modified", static_cast<double>(m_outputModified));
+
+    QJsonObject root;
+    root.insert("version", ManifestVersion);
+    root.insert("settings", m_settings);
+    root.insert("output", output);
+    root.insert("inputs", inputs);
+
+    QSaveFile file(manifestFileName(m_outputFile));
+    if(!file.open(QIODevice::WriteOnly))
+        return false;
+    file.write(QJsonDocument(root).toJson());
+    return file.commit();
+}
+
+bool ExportManifest::isUpToDate(const QStringList &inputs, const QString &settings) const
+{
+    if(settings != m_settings || inputs.size() != m_inputs.size())
+        return false;
+
+    const QFileInfo output(m_outputFile);
+    if(!output.exists() || output.size() != m_outputSize || output.lastModified().toMSecsSinceEpoch() != m_outputModified)
+        return false;
+
+    for(int i(0); i < inputs.size(); i++){
+        if(!isUnchanged(m_inputs.at(i), inputs.at(i)))
+            return false;
+    }
+    return true;
+}
+
+void ExportManifest::record(const QStringList &inputs, const QString &settings)
+{
+    QVector<Entry> entries;
+    entries.reserve(inputs.size());
+    for(int i(0); i < inputs.size(); i++){
+        const QFileInfo info(inputs.at(i));
+        Entry entry;
+        entry.path = inputs.at(i);
+        entry.size = info.size();
+        entry.modified = info.lastModified().toMSecsSinceEpoch();
+
+        //Reuse the known hash when size and timestamp did not change
+        if(i < m_inputs.size() && m_inputs.at(i).path == entry.path
+                && m_inputs.at(i).size == entry.size && m_inputs.at(i).modified == entry.modified)
+            entry.hash = m_inputs.at(i).hash;
+        else
+            entry.hash = fileHash(entry.path);
+        entries.append(entry);
+    }
+    m_inputs = entries;
+    m_settings = settings;
+
+    const QFileInfo output(m_outputFile);
+    m_outputSize = output.size();
+    m_outputModified = output.lastModified().toMSecsSinceEpoch();
+}
+
+bool ExportManifest::loadContextCache(ContextCache &cache) const
+{
+    QFile file(cacheFileName(m_outputFile));
+    if(!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_6);
+
+    quint32 magic(0), version(0);
+    stream >> magic >> version;
+    if(magic != ContextCacheMagic || version != ContextCacheVersion)
+        return false;
+
+    stream >> cache;
+    if(stream.status() != QDataStream::Ok){
+        cache.clear();
+        return false;
+    }
+    return true;
+}
+
+bool ExportManifest::saveContextCache(const ContextCache &cache) const
+{
+    QSaveFile file(cacheFileName(m_outputFile));
+    if(!file.open(QIODevice::WriteOnly))
+        return false;
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_6);
+    stream << ContextCacheMagic << ContextCacheVersion << cache;
+    return stream.status() == QDataStream::Ok && file.commit();
+}
+
+bool ExportManifest::isUnchanged(const Entry &entry, const QString &path) const
+{
+    if(entry.path != path)
+        return false;
+
+    const QFileInfo info(path);
+    if(!info.exists() || info.size() != entry.size)
+        return false;
+
+    //Same size and timestamp -> trust it, otherwise compare the content
+    if(info.lastModified().toMSecsSinceEpoch() == entry.modified)
+        return true;
+    return !entry.hash.isEmpty() && fileHash(path) == entry.hash;
+}
@@ -0,0 +1,61 @@
+#ifndef EXPORTMANIFEST_H
+#define EXPORTMANIFEST_H
+
+#include "phrasebookcore_global.h"
+#include "phrase.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QStringList>
+#include <QVector>
+
+//Phrases of a single context, keyed by the hash of the raw context text
+typedef QHash<QByteArray, QVector<Phrase>> ContextCache;
+
+//Records the content hashes of the inputs an export was created from.
+//Stored as <output>.manifest next to the exported file
+class PHRASEBOOKCORE_EXPORT ExportManifest
+{
+public:
+    explicit ExportManifest(const QString &outputFile);
+
+    static QString manifestFileName(const QString &outputFile);
+    static QString cacheFileName(const QString &outputFile);
+
+    static QByteArray fileHash(const QString &fileName);
+    static QByteArray contextHash(const QString &definition, const QString &context);
+
+    bool load();
+    bool save() const;
+
+    //True when the output is untouched and was created from the same, unchanged inputs with the same settings
+    bool isUpToDate(const QStringList &inputs, const QString &settings) const;
+
+    //Replaces the recorded state with the current inputs and output
+    void record(const QStringList &inputs, const QString &settings);
+
+    bool loadContextCache(ContextCache &cache) const;
+    bool saveContextCache(const ContextCache &cache) const;
+
+private:
+    struct Entry
+    {
+        QString path;
+        qint64 size = -1;
+        qint64 modified = -1;
+        QByteArray hash;
+    };
+
+    bool isUnchanged(const Entry &entry, const QString &path) const;
+
+private:
+    QString m_outputFile;
+    QString m_settings;
+
+    qint64 m_outputSize = -1;
+    qint64 m_outputModified = -1;
+
+    QVector<Entry> m_inputs;
+};
+
+#endif // EXPORTMANIFEST_H
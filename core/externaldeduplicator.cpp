@@ -0,0 +1,296 @@
+#include "externaldeduplicator.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QHash>
+#include <QTemporaryFile>
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+//Rough heap usage of a buffered record besides its text
+const qint64 RecordOverhead = 160;
+
+inline bool recordLess(const ExternalDeduplicator::Record &a, const ExternalDeduplicator::Record &b)
+{
+    const int compare = qstrcmp(a.key, b.key);
+    return compare < 0 || (compare == 0 && a.order < b.order);
+}
+
+//Keys are "source\x1ftarget", every target of a source is adjacent after sorting
+inline QByteArray groupKey(const QByteArray &key)
+{
+    return key.left(key.indexOf('\x1f'));
+}
+
+inline void collapse(ExternalDeduplicator::Record &kept, const ExternalDeduplicator::Record &duplicate)
+{
+    kept.count += duplicate.count;
+    kept.fileModified = qMax(kept.fileModified, duplicate.fileModified);
+}
+
+qint64 textSize(const Phrase &phrase)
+{
+    qint64 size = phrase.sourceUtf8().size() + phrase.targetUtf8().size() + phrase.definitionUtf8().size() + RecordOverhead;
+    for(const Phrase &subset : phrase.oldSources())
+        size += textSize(subset);
+    return size;
+}
+
+QDataStream &operator<<(QDataStream &stream, const ExternalDeduplicator::Record &record)
+{
+    return stream << record.key << record.order << record.count << record.fileModified << record.phrase;
+}
+
+QDataStream &operator>>(QDataStream &stream, ExternalDeduplicator::Record &record)
+{
+    return stream >> record.key >> record.order >> record.count >> record.fileModified >> record.phrase;
+}
+
+//Sequential reader of one spilled run
+struct RunReader
+{
+    explicit RunReader(QIODevice *device) : stream(device)
+    {
+        stream >> remaining;
+    }
+
+    bool next()
+    {
+        if(remaining <= 0 || stream.status() != QDataStream::Ok)
+            return false;
+        stream >> current;
+        remaining--;
+        return stream.status() == QDataStream::Ok;
+    }
+
+    QDataStream stream;
+    qint64 remaining = 0;
+    ExternalDeduplicator::Record current;
+};
+
+struct TargetVotes
+{
+    qint64 count = 0;
+    qint64 firstOrder = std::numeric_limits<qint64>::max();
+    qint64 newestFile = std::numeric_limits<qint64>::min();
+};
+}
+
+ExternalDeduplicator::ExternalDeduplicator(qint64 memoryBudget, Normalizer::Steps normalization, ConflictIndex::Policy policy) :
+    m_memoryBudget(memoryBudget), m_normalization(normalization), m_policy(policy)
+{
+
+}
+
+ExternalDeduplicator::~ExternalDeduplicator()
+{
+    qDeleteAll(m_runs);
+}
+
+bool ExternalDeduplicator::insert(const Phrase &phrase, qint64 fileModified)
+{
+    Record record;
+    record.key = matchingKey(phrase);
+    record.order = m_order++;
+    record.fileModified = fileModified;
+    record.phrase = phrase;
+
+    m_bufferBytes += record.key.size() + textSize(phrase);
+    m_buffer << record;
+
+    if(m_bufferBytes > m_memoryBudget)
+        return spill();
+    return true;
+}
+
+QByteArray ExternalDeduplicator::matchingKey(const Phrase &phrase) const
+{
+    //Same equality as PhraseCollection
+    if(m_normalization == Normalizer::NoNormalization)
+        return phrase.sourceUtf8() + '\x1f' + phrase.targetUtf8();
+    return (phrase.matchKey(m_normalization) + QChar(0x1f) + phrase.target()).toUtf8();
+}
+
+bool ExternalDeduplicator::spill()
+{
+    std::sort(m_buffer.begin(), m_buffer.end(), recordLess);
+
+    //Duplicates inside the run are collapsed before they reach the disk
+    int kept(0);
+    for(int i(0); i < m_buffer.size(); i++){
+        if(kept > 0 && m_buffer.at(kept - 1).key == m_buffer.at(i).key){
+            collapse(m_buffer[kept - 1], m_buffer.at(i));
+            m_duplicatesDropped++;
+            continue;
+        }
+        if(kept != i)
+            m_buffer[kept] = m_buffer.at(i);
+        kept++;
+    }
+    m_buffer.resize(kept);
+
+    QTemporaryFile *run = new QTemporaryFile(QDir::tempPath() + QStringLiteral("/phrasebook-run-XXXXXX"));
+    if(!run->open()){
+        delete run;
+        m_error = tr("Could not create a temporary file for the export!");
+        return false;
+    }
+    m_runs << run;
+
+    QDataStream stream(run);
+    stream << static_cast<qint64>(m_buffer.size());
+    for(const Record &record : qAsConst(m_buffer))
+        stream << record;
+
+    if(stream.status() != QDataStream::Ok || !run->flush()){
+        m_error = tr("Could not write the temporary files of the export, the disk may be full!");
+        return false;
+    }
+    m_bytesSpilled += run->size();
+
+    m_buffer.clear();
+    m_buffer.squeeze();
+    m_bufferBytes = 0;
+    return true;
+}
+
+bool ExternalDeduplicator::merge(const std::function<bool(const Phrase &)> &output)
+{
+    //Everything fit into the budget, the buffer is the only run and never touches the disk
+    if(m_runs.isEmpty())
+        std::sort(m_buffer.begin(), m_buffer.end(), recordLess);
+    else if(!m_buffer.isEmpty() && !spill())
+        return false;
+
+    //Records of one source are collected, equal keys collapse into the first record
+    QVector<Record> group;
+    bool stopped(false);
+    const auto push = [this, &group, &output, &stopped](const Record &record){
+        if(!group.isEmpty()){
+            if(group.last().key == record.key){
+                collapse(group.last(), record);
+                m_duplicatesDropped++;
+                return;
+            }
+            if(groupKey(group.last().key) != groupKey(record.key) && !flushGroup(group, output))
+                stopped = true;
+        }
+        group << record;
+    };
+
+    if(m_runs.isEmpty()){
+        for(const Record &record : qAsConst(m_buffer)){
+            push(record);
+            if(stopped)
+                return false;
+        }
+        m_buffer.clear();
+        return flushGroup(group, output);
+    }
+
+    //K-way merge, the heap holds the readers ordered by their current record
+    QVector<RunReader *> readers;
+    for(QTemporaryFile *run : qAsConst(m_runs)){
+        run->seek(0);
+        readers << new RunReader(run);
+    }
+
+    const auto heapGreater = [](RunReader *a, RunReader *b){ return recordLess(b->current, a->current); };
+    QVector<RunReader *> heap;
+    bool ok(true);
+    for(RunReader *reader : qAsConst(readers)){
+        if(reader->next())
+            heap << reader;
+        else if(reader->stream.status() != QDataStream::Ok)
+            ok = false;
+    }
+    std::make_heap(heap.begin(), heap.end(), heapGreater);
+
+    while(ok && !heap.isEmpty()){
+        std::pop_heap(heap.begin(), heap.end(), heapGreater);
+        RunReader *reader = heap.last();
+
+        push(reader->current);
+        if(stopped)
+            break;
+
+        if(reader->next()){
+            std::push_heap(heap.begin(), heap.end(), heapGreater);
+        } else {
+            heap.removeLast();
+            ok = reader->stream.status() == QDataStream::Ok;
+        }
+    }
+    qDeleteAll(readers);
+
+    if(!ok){
+        m_error = tr("Could not read the temporary files of the export!");
+        return false;
+    }
+    if(stopped)
+        return false;
+    return flushGroup(group, output);
+}
+
+bool ExternalDeduplicator::flushGroup(QVector<Record> &group, const std::function<bool(const Phrase &)> &output)
+{
+    //Same decisions as ConflictIndex, the group holds every source with the same matching key.
+    //Only groups with several targets are touched
+    bool decided(false);
+    QByteArray winner;
+    if(m_policy != ConflictIndex::KeepAll && group.size() > 1){
+        QHash<QByteArray, TargetVotes> votes;
+        for(const Record &record : qAsConst(group)){
+            if(!record.phrase.hasTranslation())
+                continue;
+
+            TargetVotes &vote = votes[record.phrase.targetUtf8()];
+            vote.count += record.count;
+            vote.firstOrder = qMin(vote.firstOrder, record.order);
+            vote.newestFile = qMax(vote.newestFile, record.fileModified);
+        }
+
+        if(votes.size() > 1){
+            const TargetVotes *best = nullptr;
+            for(auto target = votes.constBegin(); target != votes.constEnd(); ++target){
+                const TargetVotes &vote = target.value();
+                bool better = !best;
+                if(best){
+                    switch (m_policy) {
+                    case ConflictIndex::Majority:
+                        better = vote.count > best->count || (vote.count == best->count && vote.firstOrder < best->firstOrder);
+                        break;
+                    case ConflictIndex::NewestFile:
+                        better = vote.newestFile > best->newestFile || (vote.newestFile == best->newestFile && vote.firstOrder < best->firstOrder);
+                        break;
+                    default:
+                        better = vote.firstOrder < best->firstOrder;
+                        break;
+                    }
+                }
+                if(better){
+                    best = &vote;
+                    winner = target.key();
+                }
+            }
+            decided = true;
+        }
+    }
+
+    for(const Record &record : qAsConst(group)){
+        if(decided && record.phrase.hasTranslation() && record.phrase.targetUtf8() != winner){
+            m_conflictsResolved++;
+            continue;
+        }
+
+        m_uniquePhrases++;
+        if(!output(record.phrase)){
+            group.clear();
+            return false;
+        }
+    }
+    group.clear();
+    return true;
+}
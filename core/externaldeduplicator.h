@@ -0,0 +1,79 @@
+#ifndef EXTERNALDEDUPLICATOR_H
+#define EXTERNALDEDUPLICATOR_H
+
+#include "phrasebookcore_global.h"
+#include "conflictindex.h"
+#include "normalizer.h"
+#include "phrase.h"
+
+#include <QCoreApplication>
+#include <QList>
+#include <QString>
+#include <QVector>
+
+#include <functional>
+
+class QTemporaryFile;
+
+//Out-of-core counterpart of PhraseCollection and ConflictIndex. Phrases are buffered until the
+//memory budget is exceeded, then sorted by their matching key and spilled as a run into a
+//temporary file. A k-way merge of the runs drops the duplicates and resolves conflicts one
+//source at a time, so memory stays bounded by the budget and the largest group of one source.
+//The unique phrases come out sorted by source and target, not in the order they were added
+class PHRASEBOOKCORE_EXPORT ExternalDeduplicator
+{
+    Q_DECLARE_TR_FUNCTIONS(ExternalDeduplicator)
+
+public:
+    ExternalDeduplicator(qint64 memoryBudget, Normalizer::Steps normalization, ConflictIndex::Policy policy);
+    ~ExternalDeduplicator();
+
+    //Returns false if a run could not be spilled
+    bool insert(const Phrase &phrase, qint64 fileModified);
+
+    //Calls output for every unique phrase, stops as soon as output returns false
+    bool merge(const std::function<bool(const Phrase &)> &output);
+
+    inline int runCount() const {return m_runs.size();}
+    inline qint64 bytesSpilled() const {return m_bytesSpilled;}
+    inline qint64 uniquePhrases() const {return m_uniquePhrases;}
+    inline qint64 duplicatesDropped() const {return m_duplicatesDropped;}
+    inline qint64 conflictsResolved() const {return m_conflictsResolved;}
+
+    inline QString errorString() const {return m_error;}
+
+    //Every occurrence of the same key collapses into one record, the first phrase is kept
+    struct Record
+    {
+        QByteArray key;
+        qint64 order = 0;           //Insertion order of the kept phrase
+        qint64 count = 1;           //Occurrences, for the Majority policy
+        qint64 fileModified = 0;    //Newest file of any occurrence, for the NewestFile policy
+        Phrase phrase;
+    };
+
+private:
+    QByteArray matchingKey(const Phrase &phrase) const;
+    bool spill();
+    bool flushGroup(QVector<Record> &group, const std::function<bool(const Phrase &)> &output);
+
+private:
+    qint64 m_memoryBudget;
+    Normalizer::Steps m_normalization;
+    ConflictIndex::Policy m_policy;
+
+    QVector<Record> m_buffer;
+    qint64 m_bufferBytes = 0;
+    qint64 m_order = 0;
+
+    QList<QTemporaryFile *> m_runs;
+    qint64 m_bytesSpilled = 0;
+
+    qint64 m_uniquePhrases = 0;
+    qint64 m_duplicatesDropped = 0;
+    qint64 m_conflictsResolved = 0;
+
+    QString m_error;
+};
+
+#endif // EXTERNALDEDUPLICATOR_H
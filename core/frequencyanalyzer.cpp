@@ -0,0 +1,238 @@
+#include "frequencyanalyzer.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+//4 rows of 2^18 counters, 4 MB in total
+const int SketchDepth = 4;
+const int SketchWidth = 1 << 18;
+const quint64 SketchSeeds[SketchDepth] = {Q_UINT64_C(0x9e3779b97f4a7c15), Q_UINT64_C(0xbf58476d1ce4e5b9),
+                                          Q_UINT64_C(0x94d049bb133111eb), Q_UINT64_C(0xc2b2ae3d27d4eb4f)};
+
+quint64 fnv1a(const QByteArray &data)
+{
+    quint64 h = Q_UINT64_C(14695981039346656037);
+    for(const char c : data){
+        h ^= static_cast<uchar>(c);
+        h *= Q_UINT64_C(1099511628211);
+    }
+    return h;
+}
+
+//splitmix64 finalizer, turns one key hash into independent row hashes
+quint64 mix(quint64 h)
+{
+    h = (h ^ (h >> 30)) * Q_UINT64_C(0xbf58476d1ce4e5b9);
+    h = (h ^ (h >> 27)) * Q_UINT64_C(0x94d049bb133111eb);
+    return h ^ (h >> 31);
+}
+
+bool moreFrequent(const FrequencyAnalyzer::Entry &a, const FrequencyAnalyzer::Entry &b)
+{
+    return a.count > b.count || (a.count == b.count && a.source < b.source);
+}
+}
+
+FrequencyAnalyzer::FrequencyAnalyzer(Mode mode, int topK, Normalizer::Steps normalization) :
+    m_mode(mode), m_topK(qMax(1, topK)), m_normalization(normalization)
+{
+    if(m_mode == Sketch){
+        m_sketch = QVector<quint32>(SketchDepth * SketchWidth, 0);
+        m_heap.reserve(m_topK);
+        m_entries.reserve(m_topK);
+    }
+}
+
+void FrequencyAnalyzer::startFile()
+{
+    m_file++;
+}
+
+void FrequencyAnalyzer::add(const Phrase &phrase)
+{
+    if(phrase.sourceUtf8().isEmpty())
+        return;
+
+    m_occurrences++;
+    const QString key = phrase.matchKey(m_normalization);
+
+    if(m_mode == Exact){
+        Entry &entry = m_entries[key];
+        if(entry.source.isEmpty())
+            entry.source = phrase.source();
+        entry.count++;
+        record(entry, phrase);
+        return;
+    }
+
+    const qint64 estimate = addToSketch(key);
+
+    //Known candidate, its count only grows
+    const auto candidate = m_entries.find(key);
+    if(candidate != m_entries.end()){
+        candidate->count = estimate;
+        record(*candidate, phrase);
+        siftDown(m_heapPositions.value(key));
+        return;
+    }
+
+    if(m_heap.size() < m_topK){
+        m_heap << key;
+        m_heapPositions.insert(key, m_heap.size() - 1);
+    } else if(estimate > m_entries.value(m_heap.first()).count){
+        //Replaces the least frequent candidate
+        m_entries.remove(m_heap.first());
+        m_heapPositions.remove(m_heap.first());
+        m_heap[0] = key;
+        m_heapPositions.insert(key, 0);
+    } else {
+        return;
+    }
+
+    Entry &entry = m_entries[key];
+    entry.source = phrase.source();
+    entry.count = estimate;
+    record(entry, phrase);
+
+    siftUp(m_heapPositions.value(key));
+    siftDown(m_heapPositions.value(key));
+}
+
+void FrequencyAnalyzer::record(Entry &entry, const Phrase &phrase)
+{
+    entry.observed++;
+    if(phrase.hasTranslation()){
+        entry.translated++;
+        entry.translations[phrase.target()]++;
+    }
+    if(entry.lastFile != m_file){
+        entry.lastFile = m_file;
+        entry.files++;
+    }
+}
+
+qint64 FrequencyAnalyzer::addToSketch(const QString &key)
+{
+    //Conservative update, only the smallest counters grow, which keeps the overestimation low
+    int slots[SketchDepth];
+    quint32 minimum = std::numeric_limits<quint32>::max();
+    const quint64 hash = fnv1a(key.toUtf8());
+    for(int row(0); row < SketchDepth; row++){
+        slots[row] = row * SketchWidth + static_cast<int>(mix(hash ^ SketchSeeds[row]) % SketchWidth);
+        minimum = qMin(minimum, m_sketch.at(slots[row]));
+    }
+
+    if(minimum == std::numeric_limits<quint32>::max())
+        return minimum;
+
+    const quint32 estimate = minimum + 1;
+    for(int row(0); row < SketchDepth; row++){
+        quint32 &counter = m_sketch[slots[row]];
+        counter = qMax(counter, estimate);
+    }
+    return estimate;
+}
+
+void FrequencyAnalyzer::siftUp(int position)
+{
+    while(position > 0){
+        const int parent = (position - 1) / 2;
+        if(m_entries.value(m_heap.at(parent)).count <= m_entries.value(m_heap.at(position)).count)
+            break;
+        swapHeap(parent, position);
+        position = parent;
+    }
+}
+
+void FrequencyAnalyzer::siftDown(int position)
+{
+    while(true){
+        const int left = 2 * position + 1;
+        const int right = left + 1;
+        int smallest = position;
+        if(left < m_heap.size() && m_entries.value(m_heap.at(left)).count < m_entries.value(m_heap.at(smallest)).count)
+            smallest = left;
+        if(right < m_heap.size() && m_entries.value(m_heap.at(right)).count < m_entries.value(m_heap.at(smallest)).count)
+            smallest = right;
+        if(smallest == position)
+            break;
+        swapHeap(position, smallest);
+        position = smallest;
+    }
+}
+
+void FrequencyAnalyzer::swapHeap(int a, int b)
+{
+    std::swap(m_heap[a], m_heap[b]);
+    m_heapPositions.insert(m_heap.at(a), a);
+    m_heapPositions.insert(m_heap.at(b), b);
+}
+
+QVector<FrequencyAnalyzer::Entry> FrequencyAnalyzer::topEntries() const
+{
+    QVector<Entry> entries;
+    entries.reserve(m_entries.size());
+    for(const Entry &entry : m_entries)
+        entries << entry;
+
+    const int size = qMin(m_topK, entries.size());
+    std::partial_sort(entries.begin(), entries.begin() + size, entries.end(), moreFrequent);
+    entries.resize(size);
+    return entries;
+}
+
+bool FrequencyAnalyzer::writeReport(const QString &fileName) const
+{
+    QJsonArray top;
+    for(const Entry &entry : topEntries()){
+        //Variants by count, ties by text
+        QVector<QPair<QString, qint64>> variants;
+        for(auto it = entry.translations.constBegin(); it != entry.translations.constEnd(); ++it)
+            variants << qMakePair(it.key(), it.value());
+        std::sort(variants.begin(), variants.end(), [](const QPair<QString, qint64> &a, const QPair<QString, qint64> &b){
+            return a.second > b.second || (a.second == b.second && a.first < b.first);
+        });
+
+        QJsonArray translations;
+        for(const QPair<QString, qint64> &variant : qAsConst(variants)){
+            QJsonObject translation;
+            translation.insert("target", variant.first);
+            translation.insert("count", variant.second);
+            translations.append(translation);
+        }
+
+        QJsonObject source;
+        source.insert("source", entry.source);
+        source.insert("count", entry.count);
+        source.insert("files", entry.files);
+        source.insert("observed", entry.observed);
+        source.insert("translated", entry.translated);
+        source.insert("coverage", entry.observed > 0 ? static_cast<double>(entry.translated) / entry.observed : 0.0);
+        source.insert("translations", translations);
+        top.append(source);
+    }
+
+    QJsonObject root;
+    root.insert("mode", m_mode == Exact ? QStringLiteral("exact") : QStringLiteral("sketch"));
+    root.insert("occurrences", m_occurrences);
+    root.insert("files", m_file + 1);
+    if(m_mode == Exact){
+        root.insert("distinctSources", m_entries.size());
+    } else {
+        root.insert("sketchWidth", SketchWidth);
+        root.insert("sketchDepth", SketchDepth);
+    }
+    root.insert("top", top);
+
+    QSaveFile file(fileName);
+    if(!file.open(QIODevice::WriteOnly))
+        return false;
+    file.write(QJsonDocument(root).toJson());
+    return file.commit();
+}
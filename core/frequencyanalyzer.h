@@ -0,0 +1,75 @@
+#ifndef FREQUENCYANALYZER_H
+#define FREQUENCYANALYZER_H
+
+#include "phrasebookcore_global.h"
+#include "normalizer.h"
+#include "phrase.h"
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+//Counts how often sources recur across a corpus. Exact mode keeps one counter per distinct source,
+//sketch mode a fixed size count-min sketch plus the current top K candidates, so memory stays bounded.
+//Translation variants and coverage are only collected for the candidates, in sketch mode from the
+//moment a source entered the top K on
+class PHRASEBOOKCORE_EXPORT FrequencyAnalyzer
+{
+public:
+    enum Mode {
+        Exact,
+        Sketch
+    };
+
+    struct Entry
+    {
+        QString source;
+        qint64 count = 0;           //Estimated in sketch mode, never too low
+        qint64 observed = 0;        //Occurrences seen while the source was counted or a candidate
+        qint64 translated = 0;      //Observed occurrences with a translation
+        qint64 files = 0;
+        QHash<QString, qint64> translations;
+
+        int lastFile = -1;
+    };
+
+    FrequencyAnalyzer(Mode mode, int topK, Normalizer::Steps normalization = Normalizer::NoNormalization);
+
+    //Occurrences added between two calls are counted as one file
+    void startFile();
+    void add(const Phrase &phrase);
+
+    inline Mode mode() const {return m_mode;}
+    inline qint64 occurrences() const {return m_occurrences;}
+
+    //Most frequent first, ties by source
+    QVector<Entry> topEntries() const;
+
+    bool writeReport(const QString &fileName) const;
+
+private:
+    void record(Entry &entry, const Phrase &phrase);
+    qint64 addToSketch(const QString &key);
+
+    void siftUp(int position);
+    void siftDown(int position);
+    void swapHeap(int a, int b);
+
+private:
+    Mode m_mode;
+    int m_topK;
+    Normalizer::Steps m_normalization;
+
+    qint64 m_occurrences = 0;
+    int m_file = -1;
+
+    //Exact: every source, Sketch: the top K candidates
+    QHash<QString, Entry> m_entries;
+
+    QVector<quint32> m_sketch;
+    //Min heap of the candidate keys by count, with each key's position
+    QVector<QString> m_heap;
+    QHash<QString, int> m_heapPositions;
+};
+
+#endif // FREQUENCYANALYZER_H
@@ -0,0 +1,114 @@
+#include "lazyphrase.h"
+
+LazyPhrase::LazyPhrase()
+{
+
+}
+
+LazyPhrase::LazyPhrase(const QString &data, int messageBegin, int messageEnd, const QString &definition)
+    : m_data(data), m_definition(definition)
+{
+    m_source = elementContent(data, QStringLiteral("source"), messageBegin, messageEnd);
+
+    int translationTagEnd(-1);
+    m_translation = elementContent(data, QStringLiteral("translation"), messageBegin, messageEnd, &translationTagEnd);
+    if(translationTagEnd >= 0){
+        //Type attribute of the opening translation tag
+        const QString typeAttribute("type=\"");
+        const int tagBegin = data.lastIndexOf(QLatin1String("<translation"), translationTagEnd);
+        const int typeIndex = data.indexOf(typeAttribute, tagBegin);
+        if(typeIndex >= 0 && typeIndex < translationTagEnd){
+            const int valueBegin = typeIndex + typeAttribute.size();
+            const QStringRef type = data.midRef(valueBegin, data.indexOf(QChar('"'), valueBegin) - valueBegin);
+            if(type == QLatin1String("vanished"))
+                m_type = Phrase::Vanished;
+            else if(type == QLatin1String("unfinished"))
+                m_type = Phrase::Unfinished;
+            else if(type == QLatin1String("obsolete"))
+                m_type = Phrase::Obsolete;
+        }
+    }
+}
+
+QVector<LazyPhrase> LazyPhrase::fromTsData(const QString &data, const QString &defaultName)
+{
+    QVector<LazyPhrase> phrases;
+
+    const QString contextBegin("<context>"), contextEnd("</context>");
+    const QString messageBegin("<message>"), messageEnd("</message>");
+
+    int index(0);
+    while(true){
+        const int context = data.indexOf(contextBegin, index);
+        if(context < 0)
+            break;
+        const int contextClose = data.indexOf(contextEnd, context);
+        if(contextClose < 0)
+            break;
+
+        const Range nameRange = elementContent(data, QStringLiteral("name"), context, contextClose);
+        const QString definition = defaultName + QChar(' ') + XmlCodec::unescaped(data.midRef(nameRange.position, nameRange.length));
+
+        int message(context);
+        while(true){
+            message = data.indexOf(messageBegin, message);
+            if(message < 0 || message > contextClose)
+                break;
+            const int messageClose = data.indexOf(messageEnd, message);
+            if(messageClose < 0 || messageClose > contextClose)
+                break;
+
+            phrases.append(LazyPhrase(data, message, messageClose, definition));
+            message = messageClose + messageEnd.size();
+        }
+        index = contextClose + contextEnd.size();
+    }
+    return phrases;
+}
+
+LazyPhrase::Range LazyPhrase::elementContent(const QString &data, const QString &tag, int from, int to, int *tagEnd)
+{
+    Range range;
+    if(tagEnd)
+        *tagEnd = -1;
+
+    const QString open = QChar('<') + tag;
+    int index = data.indexOf(open, from);
+    while(index >= 0 && index < to){
+        //Truncated tag at the end of the data
+        if(index + open.size() >= data.size())
+            return range;
+        //Skip tags that only start with the same name, e.g. <translatorcomment>
+        const QChar next = data.at(index + open.size());
+        if(next == QChar('>') || next == QChar(' ') || next == QChar('/'))
+            break;
+        index = data.indexOf(open, index + open.size());
+    }
+    if(index < 0 || index >= to)
+        return range;
+
+    const int openEnd = data.indexOf(QChar('>'), index);
+    if(openEnd < 0 || openEnd >= to)
+        return range;
+    if(tagEnd)
+        *tagEnd = openEnd;
+
+    //Self closing, <translation type="unfinished"/>
+    if(data.at(openEnd - 1) == QChar('/')){
+        range.position = openEnd + 1;
+        range.elementBegin = index;
+        range.elementEnd = openEnd + 1;
+        return range;
+    }
+
+    const QString close = QStringLiteral("</") + tag + QChar('>');
+    const int closeIndex = data.indexOf(close, openEnd);
+    if(closeIndex < 0 || closeIndex > to)
+        return range;
+
+    range.position = openEnd + 1;
+    range.length = closeIndex - range.position;
+    range.elementBegin = index;
+    range.elementEnd = closeIndex + close.size();
+    return range;
+}
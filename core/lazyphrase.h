@@ -0,0 +1,61 @@
+#ifndef LAZYPHRASE_H
+#define LAZYPHRASE_H
+
+#include "phrasebookcore_global.h"
+#include "phrase.h"
+#include "xmlcodec.h"
+
+#include <QString>
+#include <QStringRef>
+#include <QVector>
+
+//A <message> of a ts file that only records where its elements are located.
+//The text is shared with the whole file content and only copied out when accessed. Used by the patch scan,
+//which only needs sources and translation positions. Exports still build full Phrase objects with their old sources
+class PHRASEBOOKCORE_EXPORT LazyPhrase
+{
+public:
+    LazyPhrase();
+    LazyPhrase(const QString &data, int messageBegin, int messageEnd, const QString &definition);
+
+    //Scans a whole ts file content, contexts are named like in PhrasebookMaker::parseSingleTsFile
+    static QVector<LazyPhrase> fromTsData(const QString &data, const QString &defaultName = QString());
+
+    inline bool hasTranslation() const {return m_translation.length > 0;}
+    inline Phrase::Type type() const {return m_type;}
+
+    //Raw element text, entities are still encoded
+    inline QStringRef sourceRef() const {return m_data.midRef(m_source.position, m_source.length);}
+    inline QStringRef targetRef() const {return m_data.midRef(m_translation.position, m_translation.length);}
+
+    //Whole <translation> element including its tags, length 0 if there is none
+    inline int translationElementBegin() const {return m_translation.elementBegin;}
+    inline int translationElementEnd() const {return m_translation.elementEnd;}
+
+    inline QString source() const {return XmlCodec::unescaped(sourceRef());}
+    inline QString target() const {return XmlCodec::unescaped(targetRef());}
+    inline const QString &definition() const {return m_definition;}
+
+private:
+    struct Range
+    {
+        int position = 0;
+        int length = 0;
+
+        int elementBegin = -1;
+        int elementEnd = -1;
+    };
+
+    static Range elementContent(const QString &data, const QString &tag, int from, int to, int *tagEnd = nullptr);
+
+private:
+    QString m_data;
+    QString m_definition;
+
+    Range m_source;
+    Range m_translation;
+
+    Phrase::Type m_type = Phrase::None;
+};
+
+#endif // LAZYPHRASE_H
@@ -0,0 +1,488 @@
+#include "merger.h"
+#include "xmlcodec.h"
+
+#include <QFile>
+#include <QHash>
+#include <QSaveFile>
+#include <QSet>
+#include <QStringList>
+#include <QTextStream>
+#include <QVector>
+
+#include <algorithm>
+#include <limits>
+
+#if defined(Q_OS_UNIX)
+#include <errno.h>
+#include <limits.h>
+#include <sys/uio.h>
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+#endif
+
+Merger::Merger(QObject *parent) :QObject(parent)
+{
+
+}
+
+bool Merger::Merge(const QList<QUrl> &sources, const QUrl &destination)
+{
+    m_stats.clear();
+
+    QFile targetFile(destination.toLocalFile());
+
+    if(!targetFile.exists() || !targetFile.open(QIODevice::ReadWrite)){
+        m_error = tr("Target file could not be created");
+        return false;
+    }
+
+    for(const QUrl &url : sources){
+        m_stats.startPhase(QStringLiteral("merge %1").arg(url.fileName()));
+        bool ok = m_coalesceContexts ? coalesceTwoFiles(url.toLocalFile(), destination.toLocalFile())
+                                     : mergeTwoFiles(url.toLocalFile(), destination.toLocalFile());
+        if(!ok)
+            return false ;
+    }
+
+    m_stats.finish();
+    emit statisticsAvailable(m_stats);
+    return true;
+}
+
+namespace {
+//Output as a list of byte ranges, written with as few system calls as possible
+class GatherWriter
+{
+public:
+    inline void append(const char *data, qint64 size)
+    {
+        if(size <= 0)
+            return;
+        m_slices.append(qMakePair(data, size));
+        m_size += size;
+    }
+    inline void append(const QByteArray &data) {append(data.constData(), data.size());}
+
+    inline qint64 size() const {return m_size;}
+
+    bool writeTo(QFileDevice &file) const
+    {
+#if defined(Q_OS_UNIX)
+        //Vectored writes straight onto the file descriptor, the device has to be unbuffered
+        QVector<iovec> vectors;
+        vectors.reserve(m_slices.size());
+        for(const QPair<const char *, qint64> &slice : m_slices){
+            iovec vector;
+            vector.iov_base = const_cast<char *>(slice.first);
+            vector.iov_len = static_cast<size_t>(slice.second);
+            vectors << vector;
+        }
+
+        const int fd = file.handle();
+        int first(0);
+        while(first < vectors.size()){
+            const ssize_t written = ::writev(fd, vectors.constData() + first, qMin(vectors.size() - first, IOV_MAX));
+            if(written < 0){
+                if(errno == EINTR)
+                    continue;
+                return false;
+            }
+
+            //Skip the completely written slices, trim a partially written one
+            size_t remaining = static_cast<size_t>(written);
+            while(first < vectors.size() && remaining >= vectors.at(first).iov_len){
+                remaining -= vectors.at(first).iov_len;
+                first++;
+            }
+            if(remaining > 0){
+                vectors[first].iov_base = static_cast<char *>(vectors[first].iov_base) + remaining;
+                vectors[first].iov_len -= remaining;
+            }
+        }
+        return true;
+#else
+        for(const QPair<const char *, qint64> &slice : m_slices){
+            if(file.write(slice.first, slice.second) != slice.second)
+                return false;
+        }
+        return true;
+#endif
+    }
+
+private:
+    QVector<QPair<const char *, qint64>> m_slices;
+    qint64 m_size = 0;
+};
+
+//Value of the language attribute of the <TS> tag
+QByteArray tsLanguage(const QByteArray &data)
+{
+    const int tag = data.indexOf("<TS");
+    if(tag < 0)
+        return QByteArray();
+
+    const QByteArray attribute(" language=\"");
+    const int tagEnd = data.indexOf('>', tag);
+    const int index = data.indexOf(attribute, tag);
+    if(index < 0 || (tagEnd >= 0 && index > tagEnd))
+        return QByteArray();
+
+    const int begin = index + attribute.size();
+    return data.mid(begin, data.indexOf('"', begin) - begin);
+}
+}
+
+bool Merger::mergeTwoFiles(const QString &fileA, const QString &fileB)
+{
+    //A into B
+    //Both files are memory mapped, the output is a gather list of unchanged ranges of the mappings
+    //and the few edits, nothing is decoded
+
+    QFile source(fileA);
+    if(!source.open(QIODevice::ReadOnly)){
+        m_error = tr("Could not open file \n%1").arg(fileA.splitRef(QChar('/')).last().toString());
+        return false;
+    }
+
+    QFile target(fileB);
+    if(!target.open(QIODevice::ReadOnly)){
+        m_error = tr("Could not open file \n%1").arg(fileB.splitRef(QChar('/')).last().toString());
+        return  false;
+    }
+
+    const qint64 sourceSize = source.size();
+    const qint64 targetSize = target.size();
+    if(sourceSize > std::numeric_limits<int>::max() || targetSize > std::numeric_limits<int>::max()){
+        m_error = tr("Files larger than 2 GB can not be merged!");
+        return false;
+    }
+
+    uchar *sourceMap = sourceSize > 0 ? source.map(0, sourceSize) : nullptr;
+    uchar *targetMap = targetSize > 0 ? target.map(0, targetSize) : nullptr;
+    const QByteArray a = QByteArray::fromRawData(reinterpret_cast<const char *>(sourceMap), sourceMap ? static_cast<int>(sourceSize) : 0);
+    const QByteArray b = QByteArray::fromRawData(reinterpret_cast<const char *>(targetMap), targetMap ? static_cast<int>(targetSize) : 0);
+    m_stats.bytesRead += a.size() + b.size();
+    m_stats.filesRead++;
+
+    //Everything in front of the line of the closing </TS> tag is kept
+    const int targetEnd = b.lastIndexOf("</TS>");
+    if(!b.contains("<!DOCTYPE TS>") || targetEnd < 0){
+        m_error = tr("Target file is not a valid *.ts file!");
+        return false;
+    }
+    const int insert = b.lastIndexOf('\n', targetEnd) + 1;
+
+    if(!a.contains("<!DOCTYPE TS>")){
+        m_error = tr("Source file is not a valid *.ts file!\n%1").arg(fileA.splitRef(QChar('/')).last().toString());
+        return false;
+    }
+
+    const QByteArray languageA = tsLanguage(a);
+    if(!languageA.isEmpty() && languageA != tsLanguage(b)){
+        m_error = tr("Source and Target languages do not match!");
+        return false;
+    }
+
+    //Source is inserted from the line of its first context up to its end, including its </TS>
+    const int firstContext = a.indexOf("<context>");
+    if(firstContext < 0)
+        return true;
+    const int regionBegin = a.lastIndexOf('\n', firstContext) + 1;
+
+    const QByteArray region = QByteArray::fromRawData(a.constData() + regionBegin, a.size() - regionBegin);
+    m_stats.contextsParsed += region.count("<context>");
+    m_stats.messagesParsed += region.count("<message");
+
+    //Translations without type are marked as vanished, the file name is attached to the context names
+    //to prevent potential conflicts in the translation file
+    const QByteArray translationTag("<translation>");
+    const QByteArray vanishedTag("<translation type=\"vanished\">");
+    const QByteArray nameEnd("</name>");
+    const QByteArray suffixedNameEnd = ' ' + XmlCodec::escaped(fileA.splitRef(QChar('/')).last().toUtf8()) + nameEnd;
+
+    GatherWriter output;
+    output.append(b.constData(), insert);
+
+    int copied(regionBegin);
+    int translation = a.indexOf(translationTag, copied);
+    int name = a.indexOf(nameEnd, copied);
+    while(translation >= 0 || name >= 0){
+        const bool isName = translation < 0 || (name >= 0 && name < translation);
+        const int position = isName ? name : translation;
+        output.append(a.constData() + copied, position - copied);
+
+        if(isName){
+            output.append(suffixedNameEnd);
+            copied = name + nameEnd.size();
+            name = a.indexOf(nameEnd, copied);
+        } else {
+            output.append(vanishedTag);
+            copied = translation + translationTag.size();
+            translation = a.indexOf(translationTag, copied);
+        }
+    }
+    output.append(a.constData() + copied, a.size() - copied);
+
+    QSaveFile merged(fileB);
+    if(!merged.open(QIODevice::WriteOnly | QIODevice::Unbuffered)){
+        m_error = tr("Could not open file \n%1").arg(fileB.splitRef(QChar('/')).last().toString());
+        return  false;
+    }
+
+    if(!output.writeTo(merged)){
+        m_error = tr("An error appeared during the writing process!");
+        merged.cancelWriting();
+        return false;
+    }
+    m_stats.bytesWritten += output.size();
+
+    //Mappings have to be released before the target is replaced
+    source.unmap(sourceMap);
+    target.unmap(targetMap);
+    target.close();
+
+    if(!merged.commit()){
+        m_error = tr("Could not write file \n%1\n%2").arg(fileB.splitRef(QChar('/')).last().toString(), merged.errorString());
+        return false;
+    }
+    m_stats.filesWritten++;
+    return true;
+}
+
+namespace {
+//Line aligned ranges of a context of a *.ts file
+struct TsContext
+{
+    QString name;
+    int closingLine = -1;                   //start of the line holding </context>
+    QVector<QPair<int, int>> messages;      //[begin, end) of each <message> block
+};
+
+//Context of the merge target, its messages are identified by source and comment
+struct MergeContext
+{
+    int insertPosition = -1;
+    QSet<QString> messageKeys;
+    QString newMessages;
+};
+
+//Start of the line, as long as only whitespace precedes the position
+int lineStart(const QString &data, int position)
+{
+    int i(position);
+    while(i > 0 && (data.at(i - 1) == QChar(' ') || data.at(i - 1) == QChar('\t')))
+        i--;
+    return (i == 0 || data.at(i - 1) == QChar('\n')) ? i : position;
+}
+
+QStringRef elementText(const QString &data, const QString &tag, int from, int to)
+{
+    const QString open = QStringLiteral("<%1>").arg(tag);
+    const int begin = data.indexOf(open, from);
+    if(begin < 0 || begin >= to)
+        return QStringRef();
+
+    const int end = data.indexOf(QStringLiteral("</%1>").arg(tag), begin);
+    if(end < 0 || end > to)
+        return QStringRef();
+    return data.midRef(begin + open.size(), end - begin - open.size());
+}
+
+QString messageKey(const QString &data, const QPair<int, int> &message)
+{
+    return elementText(data, QStringLiteral("source"), message.first, message.second).toString()
+            + QChar(0x1f)
+            + elementText(data, QStringLiteral("comment"), message.first, message.second).toString();
+}
+
+QVector<TsContext> scanContexts(const QString &data)
+{
+    const QString contextOpen("<context>"), contextClose("</context>");
+    const QString messageOpen("<message"), messageClose("</message>");
+
+    QVector<TsContext> contexts;
+    int position = data.indexOf(contextOpen);
+    while(position >= 0){
+        const int end = data.indexOf(contextClose, position);
+        if(end < 0)
+            break;
+
+        TsContext context;
+        context.name = elementText(data, QStringLiteral("name"), position, end).toString();
+        context.closingLine = lineStart(data, end);
+
+        int message = data.indexOf(messageOpen, position);
+        while(message >= 0 && message < end){
+            const int messageEnd = data.indexOf(messageClose, message);
+            if(messageEnd < 0 || messageEnd > end)
+                break;
+
+            int lineEnd = data.indexOf(QChar('\n'), messageEnd);
+            lineEnd = lineEnd < 0 ? data.size() : lineEnd + 1;
+            context.messages.append(qMakePair(lineStart(data, message), lineEnd));
+            message = data.indexOf(messageOpen, messageEnd);
+        }
+
+        contexts << context;
+        position = data.indexOf(contextOpen, end);
+    }
+    return contexts;
+}
+
+//Same detection as the line based merge, second word of the first line with a language attribute
+QString languageAttribute(const QString &data)
+{
+    const int position = data.indexOf(QLatin1String("language="));
+    if(position < 0)
+        return QString();
+
+    const int begin = data.lastIndexOf(QChar('\n'), position) + 1;
+    int end = data.indexOf(QChar('\n'), position);
+    if(end < 0)
+        end = data.size();
+
+    const QVector<QStringRef> refs = data.midRef(begin, end - begin).split(QChar(' '));
+    return refs.size() > 1 ? refs.at(1).toString() : QString();
+}
+}
+
+bool Merger::coalesceTwoFiles(const QString &fileA, const QString &fileB)
+{
+    //A into B, messages already known to the same named context of B are dropped
+
+    QFile source(fileA);
+    if(!source.open(QIODevice::ReadOnly)){
+        m_error = tr("Could not open file \n%1").arg(fileA.splitRef(QChar('/')).last().toString());
+        return false;
+    }
+
+    QFile target(fileB);
+    if(!target.open(QIODevice::ReadOnly)){
+        m_error = tr("Could not open file \n%1").arg(fileB.splitRef(QChar('/')).last().toString());
+        return  false;
+    }
+
+    QTextStream sourceStream(&source);
+    const QString sourceData = sourceStream.readAll();
+    QTextStream targetStream(&target);
+    const QString targetData = targetStream.readAll();
+    m_stats.bytesRead += source.size() + target.size();
+    m_stats.filesRead++;
+
+    //Close read file otherwise QSaveFile will fail on commit
+    target.close();
+
+    const int targetEnd = targetData.lastIndexOf(QLatin1String("</TS>"));
+    if(!targetData.contains(QLatin1String("<!DOCTYPE TS>")) || targetEnd < 0){
+        m_error = tr("Target file is not a valid *.ts file!");
+        return false;
+    }
+
+    if(!sourceData.contains(QLatin1String("<!DOCTYPE TS>"))){
+        m_error = tr("Source file is not a valid *.ts file!\n%1").arg(fileA.splitRef(QChar('/')).last().toString());
+        return false;
+    }
+
+    const QString languageA = languageAttribute(sourceData);
+    if(!languageA.isEmpty() && languageA != languageAttribute(targetData)){
+        m_error = tr("Source and Target languages do not match!");
+        return false;
+    }
+
+    //Index the target, duplicated context names are folded into the first one
+    QHash<QString, MergeContext> contexts;
+    for(const TsContext &context : scanContexts(targetData)){
+        MergeContext &merged = contexts[context.name];
+        if(merged.insertPosition < 0)
+            merged.insertPosition = context.closingLine;
+        for(const QPair<int, int> &message : context.messages)
+            merged.messageKeys.insert(messageKey(targetData, message));
+    }
+
+    //Only messages unknown to the target are kept, marked as vanished like in the line based merge
+    QStringList newContexts;
+    for(const TsContext &context : scanContexts(sourceData)){
+        m_stats.contextsParsed++;
+
+        auto merged = contexts.find(context.name);
+        if(merged == contexts.end()){
+            merged = contexts.insert(context.name, MergeContext());
+            newContexts << context.name;
+        }
+
+        for(const QPair<int, int> &message : context.messages){
+            m_stats.messagesParsed++;
+
+            const QString key = messageKey(sourceData, message);
+            if(merged->messageKeys.contains(key)){
+                m_stats.duplicatesDropped++;
+                continue;
+            }
+            merged->messageKeys.insert(key);
+
+            QString block = sourceData.mid(message.first, message.second - message.first);
+            block.replace(QLatin1String("<translation>"), QLatin1String("<translation type=\"vanished\">"));
+            merged->newMessages += block;
+        }
+    }
+
+    //New messages go in front of the closing tag of their context, new contexts in front of </TS>
+    QVector<QPair<int, QString>> insertions;
+    for(auto it = contexts.cbegin(); it != contexts.cend(); ++it){
+        if(it->insertPosition >= 0 && !it->newMessages.isEmpty())
+            insertions << qMakePair(it->insertPosition, it->newMessages);
+    }
+    std::sort(insertions.begin(), insertions.end(), [](const QPair<int, QString> &a, const QPair<int, QString> &b){
+        return a.first < b.first;
+    });
+
+    QString appendedContexts;
+    for(const QString &name : qAsConst(newContexts)){
+        const MergeContext &merged = contexts[name];
+        if(merged.newMessages.isEmpty())
+            continue;
+        appendedContexts += QStringLiteral("<context>\n    <name>%1</name>\n").arg(name);
+        appendedContexts += merged.newMessages;
+        appendedContexts += QStringLiteral("</context>\n");
+    }
+    if(!appendedContexts.isEmpty())
+        insertions << qMakePair(lineStart(targetData, targetEnd), appendedContexts);
+
+    if(insertions.isEmpty()){
+        //Everything is known already, the target stays untouched
+        return true;
+    }
+
+    QString merged;
+    int copied(0);
+    for(const QPair<int, QString> &insertion : qAsConst(insertions)){
+        merged.append(targetData.midRef(copied, insertion.first - copied));
+        merged.append(insertion.second);
+        copied = insertion.first;
+    }
+    merged.append(targetData.midRef(copied));
+
+    QSaveFile output(fileB);
+    if(!output.open(QIODevice::WriteOnly)){
+        m_error = tr("Could not open file \n%1").arg(fileB.splitRef(QChar('/')).last().toString());
+        return  false;
+    }
+
+    QTextStream writeStream(&output);
+    writeStream << merged;
+    writeStream.flush();
+    if(writeStream.status() != QTextStream::Ok){
+        m_error = tr("An error appeared during the writing process!");
+        output.cancelWriting();
+        return false;
+    }
+
+    m_stats.bytesWritten += output.size();
+    if(!output.commit()){
+        m_error = tr("Could not write file \n%1\n%2").arg(fileB.splitRef(QChar('/')).last().toString(), output.errorString());
+        return false;
+    }
+    m_stats.filesWritten++;
+    return true;
+}
@@ -0,0 +1,37 @@
+#ifndef MERGER_H
+#define MERGER_H
+
+#include "phrasebookcore_global.h"
+
+#include <QUrl>
+#include <QObject>
+
+#include "runstatistics.h"
+
+class PHRASEBOOKCORE_EXPORT Merger : public QObject
+{
+    Q_OBJECT
+public:
+    explicit Merger(QObject*parent = nullptr);
+
+    bool Merge(const QList<QUrl> &sources, const QUrl&destination);
+    inline const QString &error(){return  m_error;}
+    inline const RunStatistics &statistics() const {return m_stats;}
+
+    //Folds the sources into the same named contexts of the target instead of appending renamed copies
+    inline void setCoalesceContexts(bool coalesce){m_coalesceContexts = coalesce;}
+
+signals:
+    void statisticsAvailable(const RunStatistics &statistics);
+
+private:
+    bool mergeTwoFiles(const QString &fileA, const QString &fileB);
+    bool coalesceTwoFiles(const QString &fileA, const QString &fileB);
+
+private:
+    QString m_error;
+    RunStatistics m_stats;
+    bool m_coalesceContexts = false;
+};
+
+#endif // MERGER_H
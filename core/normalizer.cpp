@@ -0,0 +1,66 @@
+#include "normalizer.h"
+
+QString Normalizer::normalized(const QString &text, Steps steps)
+{
+    if(steps == NoNormalization)
+        return text;
+
+    QString key = text;
+    if(steps & StripAccelerators)
+        key = stripAccelerators(key);
+    if(steps & FoldWhitespace)
+        key = key.simplified();
+    if(steps & StripTrailingPunctuation)
+        key = stripTrailingPunctuation(key);
+    if(steps & FoldCase)
+        key = key.toCaseFolded();
+    return key;
+}
+
+QString Normalizer::stripAccelerators(const QString &text)
+{
+    if(!text.contains(QChar('&')))
+        return text;
+
+    QString stripped;
+    stripped.reserve(text.size());
+    for(int i(0); i < text.size(); i++){
+        const QChar c = text.at(i);
+        if(c != QChar('&') || i + 1 >= text.size()){
+            stripped.append(c);
+            continue;
+        }
+
+        const QChar next = text.at(i + 1);
+        if(next == QChar('&')){
+            //Escaped ampersand
+            stripped.append(c);
+            i++;
+        } else if(next.isLetterOrNumber()){
+            //Asian style accelerator in brackets, e.g. "File(&F)"
+            if(stripped.endsWith(QChar('(')) && i + 2 < text.size() && text.at(i + 2) == QChar(')')){
+                stripped.chop(1);
+                i += 2;
+            }
+        } else {
+            stripped.append(c);
+        }
+    }
+    return stripped;
+}
+
+QString Normalizer::stripTrailingPunctuation(const QString &text)
+{
+    //A single full stop is kept, it usually ends a sentence
+    int end(text.size());
+    while(end > 0){
+        const QChar c = text.at(end - 1);
+        if(c == QChar(':') || c == QChar(0x2026) || c.isSpace())
+            end--;
+        else if(end >= 3 && text.midRef(end - 3, 3) == QLatin1String("..."))
+            end -= 3;
+        else
+            break;
+    }
+    return end == text.size() ? text : text.left(end);
+}
@@ -0,0 +1,33 @@
+#ifndef NORMALIZER_H
+#define NORMALIZER_H
+
+#include "phrasebookcore_global.h"
+
+#include <QFlags>
+#include <QMetaType>
+#include <QString>
+
+//Canonical matching keys, so that sources which only differ in accelerators,
+//whitespace, trailing punctuation or case still match with a plain hash lookup.
+//Phrase text is already decoded while parsing, see XmlCodec
+class PHRASEBOOKCORE_EXPORT Normalizer
+{
+public:
+    enum Step {
+        NoNormalization = 0x0,
+        StripAccelerators = 0x1,        //&File -> File, File(&F) -> File, && -> &
+        FoldWhitespace = 0x2,           //Trims and collapses whitespace runs into one space
+        StripTrailingPunctuation = 0x4, //Trailing colons and ellipses
+        FoldCase = 0x8
+    };
+    Q_DECLARE_FLAGS(Steps, Step)
+
+    static QString normalized(const QString &text, Steps steps);
+    static QString stripAccelerators(const QString &text);
+    static QString stripTrailingPunctuation(const QString &text);
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(Normalizer::Steps)
+Q_DECLARE_METATYPE(Normalizer::Steps)
+
+#endif // NORMALIZER_H
@@ -0,0 +1,64 @@
+#ifndef PARALLELSORT_H
+#define PARALLELSORT_H
+
+#include <QFuture>
+#include <QThread>
+#include <QVector>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <algorithm>
+
+//Sorts chunks on the global thread pool and merges them pairwise,
+//the result is sorted according to lessThan. Not stable, equal elements may end up in any order
+template<typename T, typename LessThan>
+void parallelSort(QVector<T> &values, LessThan lessThan)
+{
+    const int minimumChunkSize(4096);
+    const int threads = QThread::idealThreadCount();
+    if(threads < 2 || values.size() < 2 * minimumChunkSize){
+        std::sort(values.begin(), values.end(), lessThan);
+        return;
+    }
+
+    const int chunks = qMin(threads, values.size() / minimumChunkSize);
+    QVector<int> bounds;
+    for(int i(0); i <= chunks; i++)
+        bounds << static_cast<int>(static_cast<qint64>(values.size()) * i / chunks);
+
+    //Detach once, before the data is shared between threads
+    T *data = values.data();
+
+    QVector<QFuture<void>> futures;
+    for(int i(0); i < chunks; i++){
+        const int begin = bounds.at(i);
+        const int end = bounds.at(i + 1);
+        futures << QtConcurrent::run([data, begin, end, lessThan](){
+            std::sort(data + begin, data + end, lessThan);
+        });
+    }
+    for(QFuture<void> &future : futures)
+        future.waitForFinished();
+
+    while(bounds.size() > 2){
+        futures.clear();
+        QVector<int> merged;
+        for(int i(0); i < bounds.size() - 1; i += 2){
+            merged << bounds.at(i);
+            if(i + 2 < bounds.size()){
+                const int begin = bounds.at(i);
+                const int middle = bounds.at(i + 1);
+                const int end = bounds.at(i + 2);
+                futures << QtConcurrent::run([data, begin, middle, end, lessThan](){
+                    std::inplace_merge(data + begin, data + middle, data + end, lessThan);
+                });
+            }
+        }
+        merged << bounds.last();
+
+        for(QFuture<void> &future : futures)
+            future.waitForFinished();
+        bounds = merged;
+    }
+}
+
+#endif // PARALLELSORT_H
@@ -0,0 +1,251 @@
+#include "phrase.h"
+#include "xmlcodec.h"
+
+#include <QDataStream>
+#include <QTextStream>
+
+Phrase::Phrase()
+{
+
+}
+
+Phrase::Phrase(const Phrase &phrase)
+{
+    m_source = phrase.m_source;
+    m_target = phrase.m_target;
+    m_definition = phrase.m_definition;
+    m_oldSources = phrase.m_oldSources;
+    m_translationType = phrase.m_translationType;
+    m_matchKey = phrase.m_matchKey;
+    m_matchSteps = phrase.m_matchSteps;
+}
+
+Phrase::Phrase(const QString &phraseText)
+{
+    QString subSec = subSection(phraseText,QString("source"));
+    if(!subSec.isEmpty())
+        m_source = extractInfo(subSec).toUtf8();
+
+    subSec =subSection(phraseText, QString("target"));
+    if(!subSec.isEmpty())
+        m_target = extractInfo(subSec).toUtf8();
+
+    m_translationType = extractType(phraseText);
+
+    subSec =subSection(phraseText, QString("definition"));
+    if(!subSec.isEmpty())
+        m_definition = extractInfo(subSec).toUtf8();
+}
+
+Phrase::Phrase(const QString &context, const QString &definition)
+    :  m_definition(definition.toUtf8())
+{   
+    QString subSec = subSection(context,QString("source"));
+    if(!subSec.isEmpty())
+        m_source = extractInfo(subSec).toUtf8();
+
+    subSec =subSection(context, QString("translation"));
+    if(!subSec.isEmpty())
+        m_target = extractInfo(subSec).toUtf8();
+
+    m_translationType = extractType(context);
+
+    QRegExp oldSOurceReg("<oldsource>(.*)</oldsource>");
+    oldSOurceReg.setMinimal(true);
+
+    int indexOldSources(0);
+    while(true){
+        indexOldSources = oldSOurceReg.indexIn(context,indexOldSources);
+        if(indexOldSources > 0)
+            m_oldSources.append(Phrase(extractInfo(context.mid(indexOldSources, oldSOurceReg.matchedLength())), target(), definition,type()));
+        else
+            break;
+        indexOldSources += oldSOurceReg.matchedLength();
+    }
+}
+
+Phrase::Phrase(const QString &source, const QString &target, const QString &definition, Type type)
+    : m_source(source.toUtf8()), m_target(target.toUtf8()), m_definition(definition.toUtf8()), m_translationType(type)
+{
+
+}
+
+namespace {
+QByteArray elementUtf8(const QByteArray &data, const QByteArray &tag, int from, int to)
+{
+    const int index = data.indexOf('<' + tag, from);
+    if(index < 0 || index >= to)
+        return QByteArray();
+
+    const int openEnd = data.indexOf('>', index);
+    if(openEnd < 0 || openEnd >= to || data.at(openEnd - 1) == '/')
+        return QByteArray();
+
+    const int closeIndex = data.indexOf("</" + tag + '>', openEnd);
+    if(closeIndex < 0 || closeIndex > to)
+        return QByteArray();
+    return XmlCodec::unescaped(data.mid(openEnd + 1, closeIndex - openEnd - 1));
+}
+}
+
+Phrase Phrase::fromPhrasebookEntry(const QByteArray &data, int begin, int end)
+{
+    Phrase phrase;
+    phrase.m_source = elementUtf8(data, QByteArrayLiteral("source"), begin, end);
+    phrase.m_target = elementUtf8(data, QByteArrayLiteral("target"), begin, end);
+    phrase.m_definition = elementUtf8(data, QByteArrayLiteral("definition"), begin, end);
+    return phrase;
+}
+
+QString Phrase::subSection(const QString &input, const QString &tag)
+{
+    QString expStr = QString("<%1.*>(.*)</%1>").arg(tag);
+    QRegExp r(expStr);
+    r.setMinimal(true);
+    int index = r.indexIn(input);
+    if(index > 0){
+        return  input.mid(index, r.matchedLength());
+    }
+    return  QString();
+}
+
+QString Phrase::extractInfo(const QString &line)
+{
+    QRegExp r  = QRegExp(">(.*)</");
+    r.setMinimal(false);
+    int index = r.indexIn(line);
+    if (index > 0 /*&& r.matchedLength() >3*/){
+        return XmlCodec::unescaped(line.midRef(++index, r.matchedLength() -3));
+    }
+
+    return QString();
+}
+
+bool operator >(const Phrase &phraseA, const Phrase &phraseB)
+{
+    return phraseB < phraseA;
+}
+
+bool operator <(const Phrase &phraseA, const Phrase &phraseB)
+{
+    //Canonical order: definition, source, target
+    if(phraseA.m_definition != phraseB.m_definition)
+        return phraseA.m_definition < phraseB.m_definition;
+    if(phraseA.m_source != phraseB.m_source)
+        return phraseA.m_source < phraseB.m_source;
+    return phraseA.m_target < phraseB.m_target;
+}
+
+bool operator ==(const Phrase &phraseA, const Phrase &phraseB)
+{
+    //To filter dublicates, operator == does not requiere a check for the definition
+    return  (phraseB.m_source == phraseA.m_source) && (phraseB.m_target == phraseA.m_target)/* && (phraseB.m_definition == phraseA.m_definition)*/;
+}
+
+uint qHash(const Phrase &phrase, uint seed)
+{
+    return qHash(phrase.m_source, seed) ^ qHash(phrase.m_target, seed + 1);
+}
+
+Phrase &Phrase::operator=(const Phrase &phrase)
+{
+    if(this != &phrase){
+        m_source = phrase.m_source;
+        m_target = phrase.m_target;
+        m_translationType = phrase.m_translationType;
+        m_definition = phrase.m_definition;
+        m_oldSources = phrase.m_oldSources;
+        m_matchKey = phrase.m_matchKey;
+        m_matchSteps = phrase.m_matchSteps;
+    }
+    return  *this;
+}
+
+QString Phrase::matchKey(Normalizer::Steps steps) const
+{
+    if(steps == Normalizer::NoNormalization)
+        return source();
+
+    if(m_matchSteps != static_cast<int>(steps)){
+        m_matchKey = Normalizer::normalized(source(), steps);
+        m_matchSteps = static_cast<int>(steps);
+    }
+    return m_matchKey;
+}
+
+void Phrase::detach()
+{
+    m_oldSources.detach();
+}
+
+Phrase::Type Phrase::extractType(const QString &context)
+{
+    QRegExp r("<translation type=\"(.*)\">");
+    r.setMinimal(true);
+
+    if(r.indexIn(context) >= 0 && r.capturedTexts().size() > 1){
+        //Should have 2 matches, whole expression and the part between the two " that define the type
+        //0 -> Fill capture with expression; 1 -> only the (.*) sub part
+        QString type = r.capturedTexts().at(1);
+        if(type == ("vanished"))
+            return Vanished;
+        if(type == ("unfinished"))
+            return  Unfinished;
+        if(type ==("obsolete"))
+            return  Obsolete;
+    }
+    return  None;
+}
+
+QString Phrase::toXml() const
+{
+    if(!isValid())
+        return QString();
+
+    return QString::fromUtf8(toXmlUtf8());
+}
+
+QByteArray Phrase::toXmlUtf8() const
+{
+    if(!isValid())
+        return QByteArray();
+
+    //Escaping works on the UTF-8 bytes directly, all escaped characters are ASCII
+    return QByteArrayLiteral("<phrase>\n\t<source>")
+            + XmlCodec::escaped(m_source)
+            + QByteArrayLiteral("</source>\n\t<target>")
+            + XmlCodec::escaped(m_target)
+            + QByteArrayLiteral("</target>\n\t<definition>")
+            + XmlCodec::escaped(m_definition)
+            + QByteArrayLiteral("</definition>\n</phrase>\n");
+}
+
+QTextStream &operator<<(QTextStream &stream, const Phrase &phrase)
+{
+    if(phrase.isValid())
+        stream << phrase.toXml();
+    return stream;
+}
+
+QDataStream &operator<<(QDataStream &stream, const Phrase &phrase)
+{
+    stream << phrase.m_source
+           << phrase.m_target
+           << phrase.m_definition
+           << static_cast<qint32>(phrase.m_translationType)
+           << phrase.m_oldSources;
+    return stream;
+}
+
+QDataStream &operator>>(QDataStream &stream, Phrase &phrase)
+{
+    qint32 type(Phrase::None);
+    stream >> phrase.m_source
+           >> phrase.m_target
+           >> phrase.m_definition
+           >> type
+           >> phrase.m_oldSources;
+    phrase.m_translationType = static_cast<Phrase::Type>(type);
+    phrase.m_matchSteps = -1;
+    return stream;
+}
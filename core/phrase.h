@@ -0,0 +1,94 @@
+#ifndef PHRASE_H
+#define PHRASE_H
+
+#include "phrasebookcore_global.h"
+#include "normalizer.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+//#include <QTextStream>
+
+class QDataStream;
+class QTextStream;
+class PHRASEBOOKCORE_EXPORT Phrase
+{
+public:
+
+    enum Type {None, Unfinished, Finished, Vanished, Obsolete };
+
+    Phrase();
+    Phrase(const Phrase &phrase);
+    Phrase(const QString &phraseText);
+    Phrase(const QString &context, const QString &definition);
+    Phrase(const QString &source, const QString &target, const QString &definition, Type type);
+
+    static QString subSection(const QString &input, const QString &tag);
+    //Element text with its entities decoded
+    static QString extractInfo(const QString &line);
+
+    static QString infoFromSection(const QString &input, const QString &tag){return extractInfo(subSection(input, tag));}
+
+    //<phrase> entry between begin and end of a UTF-8 phrasebook, parsed without converting to QString
+    static Phrase fromPhrasebookEntry(const QByteArray &data, int begin, int end);
+
+    inline bool isValid() const {return  !m_source.isEmpty() && !m_target.isEmpty();}
+    inline bool hasTranslation() const {return  !m_target.isEmpty();}
+
+    inline Type type() const {return  m_translationType;}
+
+    //Text is stored as UTF-8, the QString accessors convert on every call
+    inline QString source() const {return QString::fromUtf8(m_source);}
+    inline QString target() const {return QString::fromUtf8(m_target);}
+    inline QString definition() const {return  QString::fromUtf8(m_definition);}
+    inline const QVector<Phrase> oldSources() const {return  m_oldSources;}
+
+    inline const QByteArray &sourceUtf8() const {return m_source;}
+    inline const QByteArray &targetUtf8() const {return m_target;}
+    inline const QByteArray &definitionUtf8() const {return m_definition;}
+
+    inline void setTranslation(const QString &translation){m_target = translation.toUtf8();}
+
+    //Normalized source used for matching, cached until other steps are requested
+    QString matchKey(Normalizer::Steps steps) const;
+    //Own copy of the old sources too, their cached matching keys are then no longer shared with other copies
+    void detach();
+
+    //<phrase> entry as written into a phrasebook, empty for invalid phrases
+    QString toXml() const;
+    QByteArray toXmlUtf8() const;
+
+    friend PHRASEBOOKCORE_EXPORT bool operator ==(const Phrase &phraseA, const Phrase &phraseB);
+    friend bool operator !=(const Phrase &phraseA, const Phrase &phraseB) { return !(phraseA == phraseB);}
+    friend PHRASEBOOKCORE_EXPORT bool operator >(const Phrase &phraseA, const Phrase &phraseB);
+    friend PHRASEBOOKCORE_EXPORT bool operator <(const Phrase &phraseA, const Phrase &phraseB);
+    Phrase &operator=(const Phrase &phrase);
+
+    friend PHRASEBOOKCORE_EXPORT QTextStream &operator<<(QTextStream &stream, const Phrase &phrase);
+    friend PHRASEBOOKCORE_EXPORT QDataStream &operator<<(QDataStream &stream, const Phrase &phrase);
+    friend PHRASEBOOKCORE_EXPORT QDataStream &operator>>(QDataStream &stream, Phrase &phrase);
+    friend PHRASEBOOKCORE_EXPORT uint qHash(const Phrase &phrase, uint seed);
+
+private:
+    Type extractType(const QString &context);
+
+protected:
+
+    QByteArray m_source;
+    QByteArray m_target;
+    QByteArray m_definition;
+
+    QVector<Phrase> m_oldSources;
+
+    Type m_translationType = None;
+
+    mutable QString m_matchKey;
+    mutable int m_matchSteps = -1;
+};
+
+//Consistent with operator ==, source and target only
+PHRASEBOOKCORE_EXPORT uint qHash(const Phrase &phrase, uint seed = 0);
+
+#endif // PHRASE_H
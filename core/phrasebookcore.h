@@ -0,0 +1,34 @@
+#ifndef PHRASEBOOKCORE_H
+#define PHRASEBOOKCORE_H
+
+//Public API of the phrasebookcore library, only depends on QtCore and QtConcurrent
+
+//Parse & dedup
+#include "phrase.h"
+#include "lazyphrase.h"
+#include "phrasecollection.h"
+#include "externaldeduplicator.h"
+#include "normalizer.h"
+#include "xmlcodec.h"
+
+//Export, update, patch & merge
+#include "phrasebookmaker.h"
+#include "merger.h"
+#include "conflictindex.h"
+#include "phrasevalidator.h"
+#include "frequencyanalyzer.h"
+#include "sourceclusterer.h"
+
+//Sidecars and lookup tables
+#include "exportmanifest.h"
+#include "batchmanifest.h"
+#include "phrasebookfilter.h"
+#include "phrasebookindex.h"
+#include "phrasebookshards.h"
+#include "phrasetablewriter.h"
+#include "phrasetable.h"
+
+#include "progressreporter.h"
+#include "runstatistics.h"
+
+#endif // PHRASEBOOKCORE_H
@@ -0,0 +1,19 @@
+# Include from projects that link phrasebookcore, e.g. include(../core/phrasebookcore.pri)
+
+QT += concurrent
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+
+PHRASEBOOKCORE_OUT = $$shadowed($$PWD)
+win32:CONFIG(release, debug|release): PHRASEBOOKCORE_OUT = $$PHRASEBOOKCORE_OUT/release
+else:win32:CONFIG(debug, debug|release): PHRASEBOOKCORE_OUT = $$PHRASEBOOKCORE_OUT/debug
+
+LIBS += -L$$PHRASEBOOKCORE_OUT -lphrasebookcore
+
+phrasebookcore_shared {
+    DEFINES += PHRASEBOOKCORE_SHARED
+} else {
+    win32-msvc*: PRE_TARGETDEPS += $$PHRASEBOOKCORE_OUT/phrasebookcore.lib
+    else: PRE_TARGETDEPS += $$PHRASEBOOKCORE_OUT/libphrasebookcore.a
+    win32: LIBS += -lpsapi
+}
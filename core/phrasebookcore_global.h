@@ -0,0 +1,17 @@
+#ifndef PHRASEBOOKCORE_GLOBAL_H
+#define PHRASEBOOKCORE_GLOBAL_H
+
+#include <QtGlobal>
+
+//Static by default, CONFIG+=phrasebookcore_shared builds a shared library
+#if defined(PHRASEBOOKCORE_SHARED)
+#  if defined(PHRASEBOOKCORE_LIBRARY)
+#    define PHRASEBOOKCORE_EXPORT Q_DECL_EXPORT
+#  else
+#    define PHRASEBOOKCORE_EXPORT Q_DECL_IMPORT
+#  endif
+#else
+#  define PHRASEBOOKCORE_EXPORT
+#endif
+
+#endif // PHRASEBOOKCORE_GLOBAL_H
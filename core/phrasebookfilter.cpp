@@ -0,0 +1,114 @@
+#include "phrasebookfilter.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+const quint32 FilterMagic(0x51504842); //QPHB
+const quint32 FilterVersion(3);
+const int BitsPerSource(10);
+const int Probes(7);
+
+PhrasebookFilter::PhrasebookFilter()
+{
+
+}
+
+QString PhrasebookFilter::filterFileName(const QString &phrasebook)
+{
+    return phrasebook + QStringLiteral(".bloom");
+}
+
+void PhrasebookFilter::build(const QVector<Phrase> &phrases)
+{
+    const int words = qMax(1, (phrases.size() * BitsPerSource + 63) / 64);
+    m_bits = QVector<quint64>(words, 0);
+    const quint64 bitCount = static_cast<quint64>(words) * 64;
+
+    for(const Phrase &phrase : phrases){
+        if(!phrase.hasTranslation())
+            continue;
+
+        //Double hashing, the probes are h1 + i * h2
+        const quint64 h = hash(phrase.sourceUtf8());
+        const quint64 h1 = h & 0xFFFFFFFF;
+        const quint64 h2 = (h >> 32) | 1;
+        for(int i(0); i < Probes; i++){
+            const quint64 bit = (h1 + i * h2) % bitCount;
+            m_bits[static_cast<int>(bit / 64)] |= Q_UINT64_C(1) << (bit % 64);
+        }
+    }
+}
+
+bool PhrasebookFilter::save(const QString &phrasebook) const
+{
+    const QFileInfo info(phrasebook);
+
+    QSaveFile file(filterFileName(phrasebook));
+    if(!file.open(QIODevice::WriteOnly))
+        return false;
+
+    QDataStream stream(&file);
+    stream << FilterMagic << FilterVersion
+           << static_cast<qint64>(info.size())
+           << static_cast<qint64>(info.lastModified().toMSecsSinceEpoch())
+           << m_bits;
+
+    return stream.status() == QDataStream::Ok && file.commit();
+}
+
+bool PhrasebookFilter::load(const QString &phrasebook)
+{
+    m_bits.clear();
+
+    QFile file(filterFileName(phrasebook));
+    if(!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream stream(&file);
+    quint32 magic(0), version(0);
+    qint64 size(0), modified(0);
+    stream >> magic >> version >> size >> modified;
+    if(magic != FilterMagic || version != FilterVersion)
+        return false;
+
+    const QFileInfo info(phrasebook);
+    if(info.size() != size || info.lastModified().toMSecsSinceEpoch() != modified)
+        return false;
+
+    stream >> m_bits;
+    if(stream.status() != QDataStream::Ok){
+        m_bits.clear();
+        return false;
+    }
+    return true;
+}
+
+bool PhrasebookFilter::mayContain(const QString &source) const
+{
+    if(m_bits.isEmpty())
+        return true;
+
+    const quint64 bitCount = static_cast<quint64>(m_bits.size()) * 64;
+    const quint64 h = hash(source.toUtf8());
+    const quint64 h1 = h & 0xFFFFFFFF;
+    const quint64 h2 = (h >> 32) | 1;
+    for(int i(0); i < Probes; i++){
+        const quint64 bit = (h1 + i * h2) % bitCount;
+        if(!(m_bits.at(static_cast<int>(bit / 64)) & (Q_UINT64_C(1) << (bit % 64))))
+            return false;
+    }
+    return true;
+}
+
+quint64 PhrasebookFilter::hash(const QByteArray &source)
+{
+    quint64 h = Q_UINT64_C(14695981039346656037);
+    for(const char c : source){
+        h ^= static_cast<uchar>(c);
+        h *= Q_UINT64_C(1099511628211);
+    }
+    return h;
+}
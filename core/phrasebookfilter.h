@@ -0,0 +1,36 @@
+#ifndef PHRASEBOOKFILTER_H
+#define PHRASEBOOKFILTER_H
+
+#include "phrasebookcore_global.h"
+#include "phrase.h"
+
+#include <QVector>
+
+//Bloom filter over the translated sources of a phrasebook, stored in the sidecar <phrasebook>.bloom.
+//A negative answer is certain, so phrasebooks without any possible hit are never parsed
+class PHRASEBOOKCORE_EXPORT PhrasebookFilter
+{
+public:
+    PhrasebookFilter();
+
+    static QString filterFileName(const QString &phrasebook);
+
+    //About 1% false positives with 10 bits and 7 probes per source
+    void build(const QVector<Phrase> &phrases);
+    bool save(const QString &phrasebook) const;
+
+    //Fails if there is no filter or the phrasebook changed after the filter was written
+    bool load(const QString &phrasebook);
+
+    inline bool isValid() const {return !m_bits.isEmpty();}
+    bool mayContain(const QString &source) const;
+
+private:
+    //FNV-1a over the UTF-8 data, stable across platforms unlike qHash
+    static quint64 hash(const QByteArray &source);
+
+private:
+    QVector<quint64> m_bits;
+};
+
+#endif // PHRASEBOOKFILTER_H
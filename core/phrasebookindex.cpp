@@ -0,0 +1,141 @@
+#include "phrasebookindex.h"
+#include "parallelsort.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QTextCodec>
+
+const quint32 IndexMagic(0x51504858); //QPHX
+const quint32 IndexVersion(3);
+
+PhrasebookIndex::PhrasebookIndex()
+{
+
+}
+
+QString PhrasebookIndex::indexFileName(const QString &phrasebook)
+{
+    return phrasebook + QStringLiteral(".idx");
+}
+
+bool PhrasebookIndex::write(const QString &phrasebook, const QVector<qint64> &offsets, const QVector<Phrase> &phrases)
+{
+    Q_ASSERT(offsets.size() == phrases.size());
+
+    QVector<int> order(phrases.size());
+    for(int i(0); i < order.size(); i++)
+        order[i] = i;
+
+    parallelSort(order, [&phrases](int a, int b) -> bool {
+        const Phrase &phraseA = phrases.at(a);
+        const Phrase &phraseB = phrases.at(b);
+        if(phraseA.sourceUtf8() != phraseB.sourceUtf8())
+            return phraseA.sourceUtf8() < phraseB.sourceUtf8();
+        if(phraseA.targetUtf8() != phraseB.targetUtf8())
+            return phraseA.targetUtf8() < phraseB.targetUtf8();
+        //Position as last key, the sort is not stable
+        return a < b;
+    });
+
+    const QFileInfo info(phrasebook);
+
+    QSaveFile file(indexFileName(phrasebook));
+    if(!file.open(QIODevice::WriteOnly))
+        return false;
+
+    QDataStream stream(&file);
+    stream << IndexMagic << IndexVersion
+           << static_cast<qint64>(info.size())
+           << static_cast<qint64>(info.lastModified().toMSecsSinceEpoch())
+           << static_cast<quint32>(order.size());
+    for(int i : qAsConst(order))
+        stream << offsets.at(i);
+
+    return stream.status() == QDataStream::Ok && file.commit();
+}
+
+void PhrasebookIndex::remove(const QString &phrasebook)
+{
+    QFile::remove(indexFileName(phrasebook));
+}
+
+bool PhrasebookIndex::open(const QString &phrasebook)
+{
+    m_offsets.clear();
+    if(m_phrasebook.isOpen())
+        m_phrasebook.close();
+
+    QFile file(indexFileName(phrasebook));
+    if(!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream stream(&file);
+    quint32 magic(0), version(0), count(0);
+    qint64 size(0), modified(0);
+    stream >> magic >> version >> size >> modified >> count;
+    if(magic != IndexMagic || version != IndexVersion)
+        return false;
+
+    const QFileInfo info(phrasebook);
+    if(info.size() != size || info.lastModified().toMSecsSinceEpoch() != modified)
+        return false;
+
+    m_offsets.resize(static_cast<int>(count));
+    for(qint64 &offset : m_offsets)
+        stream >> offset;
+    if(stream.status() != QDataStream::Ok){
+        m_offsets.clear();
+        return false;
+    }
+
+    m_phrasebook.setFileName(phrasebook);
+    return m_phrasebook.open(QIODevice::ReadOnly);
+}
+
+QVector<Phrase> PhrasebookIndex::find(const QString &source)
+{
+    QVector<Phrase> phrases;
+    const QByteArray key = source.toUtf8();
+
+    //lower bound
+    int low(0), high(m_offsets.size());
+    while(low < high){
+        const int middle = low + (high - low) / 2;
+        if(phraseAt(middle).sourceUtf8() < key)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    for(int i(low); i < m_offsets.size(); i++){
+        const Phrase phrase = phraseAt(i);
+        if(phrase.sourceUtf8() != key)
+            break;
+        phrases.append(phrase);
+    }
+    return phrases;
+}
+
+Phrase PhrasebookIndex::phraseAt(int index)
+{
+    if(!m_phrasebook.seek(m_offsets.at(index)))
+        return Phrase();
+
+    const QByteArray closingTag("</phrase>");
+    QByteArray data;
+    int end(-1);
+    while(end < 0){
+        const QByteArray chunk = m_phrasebook.read(4096);
+        if(chunk.isEmpty())
+            return Phrase();
+        //Tag could be split between two chunks
+        const int from = qMax(0, data.size() - closingTag.size());
+        data += chunk;
+        end = data.indexOf(closingTag, from);
+    }
+
+    //Phrasebooks are written with the locale codec, see PhrasebookMaker::writePhrasebook
+    return Phrase(QTextCodec::codecForLocale()->toUnicode(data.left(end + closingTag.size())));
+}
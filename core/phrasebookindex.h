@@ -0,0 +1,39 @@
+#ifndef PHRASEBOOKINDEX_H
+#define PHRASEBOOKINDEX_H
+
+#include "phrasebookcore_global.h"
+#include "phrase.h"
+
+#include <QFile>
+#include <QVector>
+
+//Sidecar <phrasebook>.idx with the byte offsets of all <phrase> entries, ordered by UTF-8 source and target.
+//Allows binary searching a phrasebook by source without parsing it
+class PHRASEBOOKCORE_EXPORT PhrasebookIndex
+{
+public:
+    PhrasebookIndex();
+
+    static QString indexFileName(const QString &phrasebook);
+
+    //offsets[i] is the position of phrases[i] inside the phrasebook
+    static bool write(const QString &phrasebook, const QVector<qint64> &offsets, const QVector<Phrase> &phrases);
+    static void remove(const QString &phrasebook);
+
+    //Fails if there is no index or the phrasebook changed after the index was written
+    bool open(const QString &phrasebook);
+
+    inline int size() const {return m_offsets.size();}
+
+    //All phrases with the given source, in target order
+    QVector<Phrase> find(const QString &source);
+
+private:
+    Phrase phraseAt(int index);
+
+private:
+    QFile m_phrasebook;
+    QVector<qint64> m_offsets;
+};
+
+#endif // PHRASEBOOKINDEX_H
@@ -0,0 +1,2092 @@
+#include "phrasebookmaker.h"
+#include "batchmanifest.h"
+#include "externaldeduplicator.h"
+#include "frequencyanalyzer.h"
+#include "lazyphrase.h"
+#include "parallelsort.h"
+#include "phrase.h"
+#include "phrasebookfilter.h"
+#include "phrasebookindex.h"
+#include "phrasebookshards.h"
+#include "phrasecollection.h"
+#include "phrasetablewriter.h"
+#include "phrasevalidator.h"
+#include "sourceclusterer.h"
+#include "xmlcodec.h"
+
+#include <QCryptographicHash>
+#include <QFile>
+#include <QDateTime>
+#include <QLockFile>
+#include <QMutex>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QTextCodec>
+#include <QTextStream>
+#include <QtConcurrent/QtConcurrentMap>
+
+PhrasebookMaker::PhrasebookMaker(QObject *parent) : QObject(parent), m_progress(this)
+{
+    //Direct: the reporter may publish from worker threads while this thread is busy
+    connect(&m_progress, &ProgressReporter::progressMaximum, this, &PhrasebookMaker::progressMaximum, Qt::DirectConnection);
+    connect(&m_progress, &ProgressReporter::progressValue, this, &PhrasebookMaker::progressValue, Qt::DirectConnection);
+}
+
+void PhrasebookMaker::setOptions(Options options)
+{
+    m_options = options;
+}
+
+void PhrasebookMaker::setMemoryBudget(qint64 bytes)
+{
+    //Smaller budgets spill a run every few phrases and the merge would open all of them at once
+    m_memoryBudget = qMax(Q_INT64_C(16) * 1024 * 1024, bytes);
+}
+
+void PhrasebookMaker::setShardCount(int count)
+{
+    m_shardCount = qBound(1, count, 256);
+}
+
+void PhrasebookMaker::setConflictPolicy(ConflictIndex::Policy policy)
+{
+    m_conflictPolicy = policy;
+}
+
+void PhrasebookMaker::setNormalization(Normalizer::Steps normalization)
+{
+    m_normalization = normalization;
+    m_conflicts = ConflictIndex(normalization);
+}
+
+namespace {
+struct ExportJob
+{
+    QUrl url;
+    QVector<Phrase> phrases;
+    PhraseCollection uniquePhrases;
+    ContextCache contexts;
+    RunStatistics stats;
+};
+}
+
+void PhrasebookMaker::exportFilesToSingleNewPhrasebook(const QList<QUrl> &sources, const QUrl &destination, const QString &sourceLanguage)
+{
+    m_stats.clear();
+    m_stats.startPhase(QStringLiteral("validate"));
+    m_conflicts.clear();
+    init(sources, sourceLanguage);
+
+    //Assumption, sources are *.ts files, destionation is a already existing *.qph file
+    if(!preprocessSources(sources))
+        return;
+
+    if(!destination.isValid()){
+        emit error(tr("No target file specified!"));
+        return;
+    }
+
+    QString defaultName = destination.fileName();
+    defaultName.replace(".ts", ".qph");
+
+    const QString fileName = destination.toLocalFile().replace(destination.fileName(), defaultName);
+    defaultName = defaultName.split('.').first();
+    //Out-of-core exports are streamed into a single phrasebook
+    const QUrl output = QUrl::fromLocalFile(m_options.testFlag(OutOfCoreExport) ? fileName : outputFileName(fileName));
+
+    //Incremental export: skip when nothing changed, otherwise reuse the phrases of unchanged contexts
+    const bool incremental = m_options.testFlag(IncrementalExport);
+    //Out-of-core exports keep no context cache, it would hold every parsed phrase in memory
+    const bool cacheContexts = incremental && !m_options.testFlag(OutOfCoreExport);
+    QStringList inputs;
+    for(const QUrl &url : sources)
+        inputs << url.toLocalFile();
+    const QString settings = QStringList{m_sourceLanguage, m_targetLanguage, defaultName, outputSettings()}.join('|');
+
+    ExportManifest manifest(output.toLocalFile());
+    ContextCache previousContexts, currentContexts;
+    if(incremental && manifest.load()){
+        if(manifest.isUpToDate(inputs, settings)){
+            m_stats.filesSkipped += sources.size();
+            m_progress.finish();
+            finishRun();
+            emit success();
+            emit newlyCreatedFiles(QList<QUrl>{output});
+            return;
+        }
+        if(cacheContexts)
+            manifest.loadContextCache(previousContexts);
+    }
+
+    //Actual read
+    m_stats.startPhase(QStringLiteral("parse & dedup"));
+    if(m_options.testFlag(OutOfCoreExport)){
+        //Bounded memory, only one parsed file and the buffer of the current run are kept
+        ExternalDeduplicator deduplicator(m_memoryBudget, m_normalization, m_conflictPolicy);
+        for(const QUrl &url : sources){
+            const QVector<Phrase> phrases = parseSingleTsFile(url, defaultName);
+            const qint64 fileModified = QFileInfo(url.toLocalFile()).lastModified().toMSecsSinceEpoch();
+
+            bool ok(true);
+            for(const Phrase &p : phrases){
+                ok = ok && deduplicator.insert(p, fileModified);
+                for(const Phrase &subset : p.oldSources()){
+                    m_stats.oldSourceExpansions++;
+                    ok = ok && deduplicator.insert(subset, fileModified);
+                }
+            }
+            if(!ok){
+                emit error(deduplicator.errorString());
+                return;
+            }
+        }
+
+        m_stats.startPhase(QStringLiteral("merge runs & write"));
+        if(!writeSpilledPhrasebook(fileName, deduplicator))
+            return;
+    } else {
+        //Each source is parsed and deduplicated on its own thread. The reduce inserts the local, first seen ordered
+        //sets in source order, which keeps exactly the phrases and the order of a sequential run
+        QVector<ExportJob> jobs;
+        for(const QUrl &url : sources){
+            ExportJob job;
+            job.url = url;
+            job.uniquePhrases = PhraseCollection(m_normalization);
+            jobs << job;
+        }
+
+        const ContextCache *previous = incremental ? &previousContexts : nullptr;
+        const bool trackConflicts = m_conflictPolicy != ConflictIndex::KeepAll;
+        const bool normalized = m_normalization != Normalizer::NoNormalization;
+        ProgressReporter *progress = &m_progress;
+        QtConcurrent::blockingMap(jobs, [&defaultName, previous, incremental, trackConflicts, normalized, progress](ExportJob &job){
+            job.phrases = parseTsFile(job.url, defaultName, previous, incremental ? &job.contexts : nullptr, job.stats, progress);
+
+            //Reused contexts share their phrases and old sources with other jobs, the cached matching keys must not be written concurrently
+            if(normalized){
+                for(Phrase &p : job.phrases)
+                    p.detach();
+            }
+            addUniquePhrases(job.uniquePhrases, job.phrases, job.stats);
+
+            if(!trackConflicts)
+                job.phrases.clear();
+        });
+
+        PhraseCollection uniquePhrases(m_normalization);
+        for(const ExportJob &job : qAsConst(jobs)){
+            m_stats.merge(job.stats);
+            for(const Phrase &p : job.uniquePhrases.phrases()){
+                if(!uniquePhrases.insert(p))
+                    m_stats.duplicatesDropped++;
+            }
+            addConflicts(job.phrases, job.url);
+
+            for(auto it = job.contexts.constBegin(); it != job.contexts.constEnd(); ++it)
+                currentContexts.insert(it.key(), it.value());
+        }
+        jobs.clear();
+        m_stats.uniquePhrases = uniquePhrases.size();
+
+        m_stats.startPhase(QStringLiteral("write"));
+        if(!writePhrasebook(fileName, m_sourceLanguage, m_targetLanguage, resolveConflicts(uniquePhrases.phrases())))
+            return;
+    }
+
+    if(incremental){
+        manifest.record(inputs, settings);
+        manifest.save();
+        if(cacheContexts)
+            manifest.saveContextCache(currentContexts);
+        else
+            QFile::remove(ExportManifest::cacheFileName(output.toLocalFile()));
+    }
+
+    m_progress.finish();
+
+    finishRun();
+    emit success();
+    emit newlyCreatedFiles(QList<QUrl>{output});
+}
+
+void PhrasebookMaker::exportFilesToNewPhrasebooks(const QList<QUrl> &sources, const QString &sourceLanguage)
+{
+    m_stats.clear();
+    init(sources, sourceLanguage);
+
+    //Checkpoint after every file, a rerun of the same batch continues with the first incomplete one
+    const bool skipFailing = m_options.testFlag(SkipFailingFiles);
+    QStringList inputs;
+    for(const QUrl &url : sources)
+        inputs << url.toLocalFile();
+    BatchManifest batch(QStringLiteral("export phrasebooks"), inputs, batchSettings(sourceLanguage));
+    batch.load();
+
+    QList<QUrl> nUrls;
+    QStringList failures;
+    for( const QUrl &url : sources){
+        const QString input = url.toLocalFile();
+        if(batch.isDone(input)){
+            m_stats.filesSkipped++;
+            m_progress.advance(QFileInfo(input).size());
+            continue;
+        }
+
+        QStringList itemErrors;
+        m_collectedErrors = &itemErrors;
+        QString output;
+        const bool exported = exportToNewPhrasebook(url, nUrls, output);
+        m_collectedErrors = nullptr;
+
+        if(!exported){
+            batch.markFailed(input, itemErrors.join(' '));
+            batch.save();
+            if(!skipFailing){
+                emit error(itemErrors.join('\n'));
+                return;
+            }
+
+            failures << QStringLiteral("%1: %2").arg(url.fileName(), itemErrors.join(' '));
+            m_progress.advance(QFileInfo(input).size());
+            continue;
+        }
+
+        batch.markDone(input, output);
+        batch.save();
+    }
+
+    if(failures.isEmpty())
+        batch.remove();
+
+    m_progress.finish();
+    finishRun();
+    if(!failures.isEmpty()){
+        emit error(tr("These files were skipped, run the same export again to retry only them:\n%1").arg(failures.join('\n')));
+        emit newlyCreatedFiles(nUrls);
+        return;
+    }
+    emit success();
+    emit newlyCreatedFiles(nUrls);
+}
+
+bool PhrasebookMaker::exportToNewPhrasebook(const QUrl &url, QList<QUrl> &createdFiles, QString &outputFile)
+{
+    m_stats.startPhase(QStringLiteral("validate %1").arg(url.fileName()));
+    if(!preprocessSources(QList<QUrl>{url}))
+        return false;
+
+    /*  Steps:
+        - Read source file
+        - Extract it into QVector of Phrase
+        - Merge Phrases & SubPhrases, exclude dublicates
+        - write into new file
+    */
+
+    //Prepare write & read
+    QString defaultName = url.fileName();
+    defaultName.replace(".ts", ".qph");
+    createdFiles.append(QUrl::fromLocalFile(outputFileName(defaultName)));
+
+    const QString fileName = url.toLocalFile().replace(url.fileName(), defaultName);
+    defaultName = defaultName.split('.').first();
+    outputFile = outputFileName(fileName);
+
+    const QStringList inputs{url.toLocalFile()};
+    const QString settings = QStringList{m_sourceLanguage, m_targetLanguage, defaultName, outputSettings()}.join('|');
+    ExportManifest manifest(outputFile);
+    if(m_options.testFlag(IncrementalExport) && manifest.load() && manifest.isUpToDate(inputs, settings)){
+        //Unchanged since the last export
+        m_stats.filesSkipped++;
+        m_progress.advance(QFileInfo(url.toLocalFile()).size());
+        return true;
+    }
+
+    //Read
+    m_stats.startPhase(QStringLiteral("parse & dedup %1").arg(url.fileName()));
+
+    //Entangle & Filter
+    m_conflicts.clear();
+    PhraseCollection uniquePhrases(m_normalization);
+    addUniquePhrases(uniquePhrases, parseSingleTsFile(url, defaultName), url);
+    m_stats.uniquePhrases += uniquePhrases.size();
+
+    //actual writing
+    m_stats.startPhase(QStringLiteral("write %1").arg(url.fileName()));
+    if(!writePhrasebook(fileName, m_sourceLanguage, m_targetLanguage, resolveConflicts(uniquePhrases.phrases())))
+        return false;
+
+    if(m_options.testFlag(IncrementalExport)){
+        manifest.record(inputs, settings);
+        manifest.save();
+    }
+    return true;
+}
+
+QString PhrasebookMaker::batchSettings(const QString &extra) const
+{
+    return QStringList{extra, outputSettings()}.join('|');
+}
+
+QString PhrasebookMaker::outputSettings() const
+{
+    //Everything that changes the written files
+    const Options outputOptions = m_options & (CanonicalOutput | OutOfCoreExport | ShardedOutput);
+    const int shardCount = m_options.testFlag(ShardedOutput) ? m_shardCount : 0;
+    return QStringList{QString::number(outputOptions), QString::number(m_conflictPolicy), QString::number(m_normalization),
+                       QString::number(shardCount)}.join(',');
+}
+
+void PhrasebookMaker::reportError(const QString &message)
+{
+    if(m_collectedErrors)
+        m_collectedErrors->append(message);
+    else
+        emit error(message);
+}
+
+const int FileModeUndefined(-1);
+const int FileModeTS(0);
+const int FileModeQPH(1);
+
+//Number of appended journal segments after which a phrasebook gets rewritten in canonical form
+const int JournalCompactionThreshold(16);
+const QString JournalMarker("<!-- journal -->");
+
+//How long a locked update waits for other jobs to finish their commit
+const int UpdateLockTimeout(5 * 60 * 1000);
+
+namespace {
+//State of a file as read, the content hash is only compared when size and modification time match
+struct FileSnapshot
+{
+    static FileSnapshot take(const QString &fileName)
+    {
+        FileSnapshot snapshot;
+        const QFileInfo info(fileName);
+        snapshot.exists = info.exists();
+        snapshot.size = info.size();
+        snapshot.modified = info.lastModified().toMSecsSinceEpoch();
+        snapshot.hash = contentHash(fileName);
+        return snapshot;
+    }
+
+    bool matches(const QString &fileName) const
+    {
+        const QFileInfo info(fileName);
+        if(info.exists() != exists || info.size() != size || info.lastModified().toMSecsSinceEpoch() != modified)
+            return false;
+        return !exists || contentHash(fileName) == hash;
+    }
+
+    static QByteArray contentHash(const QString &fileName)
+    {
+        QFile file(fileName);
+        if(!file.open(QIODevice::ReadOnly))
+            return QByteArray();
+
+        QCryptographicHash hash(QCryptographicHash::Sha1);
+        hash.addData(&file);
+        return hash.result();
+    }
+
+    bool exists = false;
+    qint64 size = 0;
+    qint64 modified = 0;
+    QByteArray hash;
+};
+}
+
+void PhrasebookMaker::updatePhrasebookFromFiles(const QList<QUrl> &sources, const QUrl &targetPhrasebook, const QString &sourceLanguage)
+{
+    // - ID if sources are TS or QPH and if they are mixed
+    // - Parse target phrasebook and extract phrases
+    // - extract phrases from sources
+    // - patch phrases from target phrasebook
+    // - write new file at target location, with the patched phrases
+
+    m_stats.clear();
+    m_stats.startPhase(QStringLiteral("validate"));
+
+    int fileMode(FileModeUndefined);
+    QString languageSource, languageTarget;
+    if(!validateUpdateSources(sources, targetPhrasebook, sourceLanguage, fileMode, languageSource, languageTarget))
+        return;
+
+    //Now the actual patching
+
+    //Locked update: remember the state of the target before it is read, the phrases the sources add are kept for a re-merge
+    const bool locked = m_options.testFlag(LockedUpdate);
+    const QString fileName = targetPhrasebook.toLocalFile();
+    const FileSnapshot snapshot = locked ? FileSnapshot::take(fileName) : FileSnapshot();
+    QVector<QPair<QUrl, QVector<Phrase>>> addedPhrases;
+
+    //Extract Phrases from target and add phrases when not existend
+    m_stats.startPhase(QStringLiteral("parse & dedup"));
+    m_conflicts.clear();
+    PhraseCollection existingPhrases(m_normalization);
+    addUniquePhrases(existingPhrases, phrasesFromPhrasebook(targetPhrasebook), targetPhrasebook);
+    addUpdatePhrases(existingPhrases, sources, targetPhrasebook, fileMode, locked ? &addedPhrases : nullptr);
+
+    //Only the commit is serialized, other jobs parse and deduplicate concurrently
+    QLockFile lock(fileName + QStringLiteral(".lock"));
+    //A slow commit of a large phrasebook must not be taken for a stale lock, locks of crashed processes on the same host are still detected
+    lock.setStaleLockTime(0);
+    if(locked){
+        m_stats.startPhase(QStringLiteral("lock"));
+        if(!lock.tryLock(UpdateLockTimeout)){
+            emit error(tr("Could not lock the phrasebook, another update holds the lock for too long"));
+            return;
+        }
+
+        if(!snapshot.matches(fileName)){
+            //Another job committed in the meantime, only the phrases this update added are merged into its phrasebook
+            m_stats.startPhase(QStringLiteral("re-merge"));
+            m_conflicts.clear();
+            existingPhrases = PhraseCollection(m_normalization);
+            addUniquePhrases(existingPhrases, phrasesFromPhrasebook(targetPhrasebook), targetPhrasebook);
+            for(const QPair<QUrl, QVector<Phrase>> &added : qAsConst(addedPhrases))
+                addUniquePhrases(existingPhrases, added.second, added.first);
+        }
+        addedPhrases.clear();
+    }
+    m_stats.uniquePhrases = existingPhrases.size();
+
+    //Save to HD
+    m_stats.startPhase(QStringLiteral("write"));
+    if(!writePhrasebook(fileName, languageSource, languageTarget, resolveConflicts(existingPhrases.phrases())))
+        return;
+    if(locked)
+        lock.unlock();
+
+    m_progress.finish();
+    finishRun();
+    emit success();
+}
+
+void PhrasebookMaker::appendToPhrasebookFromFiles(const QList<QUrl> &sources, const QUrl &targetPhrasebook, const QString &sourceLanguage)
+{
+    // Same as updatePhrasebookFromFiles, but instead of rewriting the whole target,
+    // only the new phrases are written in front of the closing </QPH> tag
+
+    if(!QFileInfo::exists(targetPhrasebook.toLocalFile()) || PhrasebookShards::isIndexFile(targetPhrasebook.toLocalFile())){
+        //Nothing to append to, or shards which are always rewritten as a whole
+        updatePhrasebookFromFiles(sources, targetPhrasebook, sourceLanguage);
+        return;
+    }
+
+    m_stats.clear();
+    m_stats.startPhase(QStringLiteral("validate"));
+
+    int fileMode(FileModeUndefined);
+    QString languageSource, languageTarget;
+    if(!validateUpdateSources(sources, targetPhrasebook, sourceLanguage, fileMode, languageSource, languageTarget))
+        return;
+
+    m_stats.startPhase(QStringLiteral("parse & dedup"));
+    int journalSegments(0);
+    m_conflicts.clear();
+    PhraseCollection phrases(m_normalization);
+    addUniquePhrases(phrases, phrasesFromPhrasebook(targetPhrasebook, &journalSegments), targetPhrasebook);
+    const int existingCount = phrases.size();
+    addUpdatePhrases(phrases, sources, targetPhrasebook, fileMode);
+    m_stats.uniquePhrases = phrases.size();
+
+    m_stats.startPhase(QStringLiteral("write"));
+    if(journalSegments + 1 >= JournalCompactionThreshold){
+        //Too many journal segments, rewrite the phrasebook in canonical form
+        if(!writePhrasebook(targetPhrasebook.toLocalFile(), languageSource, languageTarget, resolveConflicts(phrases.phrases())))
+            return;
+    } else if(phrases.size() > existingCount){
+        //Existing entries can not be dropped from the file, the policy only filters the appended ones
+        const QVector<Phrase> newPhrases = resolveConflicts(phrases.phrases().mid(existingCount));
+        if(!appendToPhrasebook(targetPhrasebook.toLocalFile(), newPhrases))
+            return;
+    }
+    //else : No new phrases -> nothing to write
+
+    m_progress.finish();
+    finishRun();
+    emit success();
+}
+
+void PhrasebookMaker::compactPhrasebook(const QUrl &phrasebook)
+{
+    m_stats.clear();
+    m_stats.startPhase(QStringLiteral("validate"));
+    m_progress.reset();
+    m_progress.addToTotal(QFileInfo(phrasebook.toLocalFile()).size());
+
+    QString languageSource, languageTarget;
+    QFile readFile(PhrasebookShards::headerFileName(phrasebook.toLocalFile()));
+    if(!readFile.open(QIODevice::ReadOnly)){
+        emit error(tr("Target file could not be opened!"));
+        return;
+    }
+    //Header is at the very beginning of the file
+    const QString header = readFile.read(1024);
+    readFile.close();
+
+    QRegExp regEx("<QPH sourcelanguage=\"(.*)\"");
+    regEx.setMinimal(true);
+    int index = regEx.indexIn(header);
+    if(index <0){
+        emit error("Parse error of target file!");
+        return ;
+    }
+    languageSource = header.mid(index + 21, 5);
+
+    regEx.setPattern("language=\"(.*)\"");
+    index = regEx.indexIn(header, index + 21);
+    if(index <0){
+        emit error("Parse error of target file!");
+        return ;
+    }
+    languageTarget = header.mid(index + 10, 5);
+
+    m_stats.startPhase(QStringLiteral("parse & dedup"));
+    PhraseCollection phrases(m_normalization);
+    addUniquePhrases(phrases, phrasesFromPhrasebook(phrasebook));
+    m_stats.uniquePhrases = phrases.size();
+
+    m_stats.startPhase(QStringLiteral("write"));
+    if(!writePhrasebook(phrasebook.toLocalFile(), languageSource, languageTarget, phrases.phrases()))
+        return;
+
+    m_progress.finish();
+    finishRun();
+    emit success();
+}
+
+void PhrasebookMaker::exportPhrasebooksToLookupTables(const QList<QUrl> &phrasebooks)
+{
+    m_stats.clear();
+    m_stats.startPhase(QStringLiteral("validate"));
+    m_progress.reset();
+
+    for(const QUrl &url : phrasebooks){
+        if(!isPhrasebook(url.fileName())){
+            emit error(tr("Please select only phrasebook files"));
+            return;
+        }
+        m_progress.addToTotal(QFileInfo(url.toLocalFile()).size());
+    }
+
+    //One *.qpt next to every phrasebook
+    m_stats.startPhase(QStringLiteral("compile tables"));
+    for(const QUrl &url : phrasebooks){
+        const QVector<Phrase> phrases = phrasesFromPhrasebook(url);
+        if(phrases.isEmpty())
+            return;
+
+        const QString fileName = PhraseTableWriter::tableFileName(url.toLocalFile());
+        QString errorMessage;
+        int written(0);
+        if(!PhraseTableWriter::write(fileName, phrases, errorMessage, &written)){
+            emit error(errorMessage);
+            return;
+        }
+
+        m_stats.uniquePhrases += written;
+        m_stats.bytesWritten += QFileInfo(fileName).size();
+        m_stats.filesWritten++;
+    }
+
+    m_progress.finish();
+    finishRun();
+    emit success();
+}
+
+void PhrasebookMaker::reportConflicts(const QList<QUrl> &sources, const QUrl &report)
+{
+    m_stats.clear();
+    m_stats.startPhase(QStringLiteral("parse"));
+    m_progress.reset();
+    for(const QUrl &url : sources)
+        m_progress.addToTotal(QFileInfo(url.toLocalFile()).size());
+
+    if(sources.isEmpty()){
+        emit error(tr("No files selected"));
+        return;
+    }
+
+    ConflictIndex conflicts(m_normalization);
+    for(const QUrl &url : sources){
+        const QFileInfo info(url.toLocalFile());
+        const QVector<Phrase> phrases = isPhrasebook(url.fileName()) ?
+                    phrasesFromPhrasebook(url) :
+                    parseSingleTsFile(url, info.baseName());
+
+        const qint64 fileModified = info.lastModified().toMSecsSinceEpoch();
+        for(const Phrase &p : phrases){
+            conflicts.add(p, info.filePath(), fileModified);
+            for(const Phrase &subset : p.oldSources())
+                conflicts.add(subset, info.filePath(), fileModified);
+        }
+    }
+
+    m_stats.startPhase(QStringLiteral("report"));
+    if(!conflicts.writeReport(report.toLocalFile())){
+        emit error(tr("Could not write the conflict report"));
+        return;
+    }
+    m_stats.filesWritten++;
+
+    m_progress.finish();
+    finishRun();
+    emit success();
+}
+
+void PhrasebookMaker::analyzeFrequencies(const QList<QUrl> &sources, const QUrl &report)
+{
+    //Corpora up to this size are counted exactly, larger ones through the sketch
+    const qint64 exactLimit = Q_INT64_C(64) * 1024 * 1024;
+    const int topK = 200;
+
+    m_stats.clear();
+    m_stats.startPhase(QStringLiteral("parse & count"));
+    m_progress.reset();
+
+    if(sources.isEmpty()){
+        emit error(tr("No files selected"));
+        return;
+    }
+
+    qint64 totalSize(0);
+    for(const QUrl &url : sources)
+        totalSize += QFileInfo(url.toLocalFile()).size();
+    m_progress.addToTotal(totalSize);
+
+    //Only one parsed file is kept in memory at a time
+    FrequencyAnalyzer analyzer(totalSize <= exactLimit ? FrequencyAnalyzer::Exact : FrequencyAnalyzer::Sketch, topK, m_normalization);
+    for(const QUrl &url : sources){
+        const QFileInfo info(url.toLocalFile());
+        const QVector<Phrase> phrases = isPhrasebook(url.fileName()) ?
+                    phrasesFromPhrasebook(url) :
+                    parseSingleTsFile(url, info.baseName());
+
+        analyzer.startFile();
+        for(const Phrase &p : phrases)
+            analyzer.add(p);
+    }
+
+    m_stats.startPhase(QStringLiteral("report"));
+    if(!analyzer.writeReport(report.toLocalFile())){
+        emit error(tr("Could not write the frequency report"));
+        return;
+    }
+    m_stats.filesWritten++;
+
+    m_progress.finish();
+    finishRun();
+    emit success();
+}
+
+void PhrasebookMaker::clusterSimilarSources(const QList<QUrl> &sources, const QUrl &report)
+{
+    m_stats.clear();
+    m_stats.startPhase(QStringLiteral("parse"));
+    m_progress.reset();
+    for(const QUrl &url : sources)
+        m_progress.addToTotal(QFileInfo(url.toLocalFile()).size());
+
+    if(sources.isEmpty()){
+        emit error(tr("No files selected"));
+        return;
+    }
+
+    SourceClusterer clusterer;
+    for(const QUrl &url : sources){
+        const QFileInfo info(url.toLocalFile());
+        const QVector<Phrase> phrases = isPhrasebook(url.fileName()) ?
+                    phrasesFromPhrasebook(url) :
+                    parseSingleTsFile(url, info.baseName());
+        for(const Phrase &p : phrases)
+            clusterer.add(p);
+    }
+    m_stats.uniquePhrases = clusterer.sourceCount();
+
+    m_stats.startPhase(QStringLiteral("cluster & report"));
+    if(!clusterer.writeReport(report.toLocalFile())){
+        emit error(tr("Could not write the cluster report"));
+        return;
+    }
+    m_stats.filesWritten++;
+
+    m_progress.finish();
+    finishRun();
+    emit success();
+}
+
+void PhrasebookMaker::validateTranslations(const QList<QUrl> &sources, const QUrl &report)
+{
+    m_stats.clear();
+    m_stats.startPhase(QStringLiteral("parse & validate"));
+    m_progress.reset();
+    for(const QUrl &url : sources)
+        m_progress.addToTotal(QFileInfo(url.toLocalFile()).size());
+
+    if(sources.isEmpty()){
+        emit error(tr("No files selected"));
+        return;
+    }
+
+    //Each file is checked in parallel chunks right after it was parsed
+    PhraseValidator validator;
+    for(const QUrl &url : sources){
+        const QFileInfo info(url.toLocalFile());
+        const QVector<Phrase> phrases = isPhrasebook(url.fileName()) ?
+                    phrasesFromPhrasebook(url) :
+                    parseSingleTsFile(url, info.baseName());
+        validator.add(phrases, info.filePath());
+    }
+    m_stats.validationFindings = validator.findings().size();
+
+    m_stats.startPhase(QStringLiteral("report"));
+    if(!validator.writeReport(report.toLocalFile())){
+        emit error(tr("Could not write the validation report"));
+        return;
+    }
+    m_stats.filesWritten++;
+
+    m_progress.finish();
+    finishRun();
+    emit success();
+}
+
+bool PhrasebookMaker::validateUpdateSources(const QList<QUrl> &sources, const QUrl &targetPhrasebook, const QString &sourceLanguage, int &fileMode, QString &languageSource, QString &languageTarget)
+{
+    m_progress.reset();
+    m_progress.addToTotal(QFileInfo(targetPhrasebook.toLocalFile()).size());
+    for(const QUrl &url : sources)
+        m_progress.addToTotal(QFileInfo(url.toLocalFile()).size());
+
+    fileMode = FileModeUndefined;
+    languageSource.clear();
+    languageTarget.clear();
+    for(const QUrl &url : sources){
+        QFile readFile(PhrasebookShards::headerFileName(url.toLocalFile()));
+        if(readFile.open(QIODevice::ReadOnly)){
+            QString content = readFile.readAll();
+            readFile.close();
+
+            int cFileMode(FileModeUndefined);
+
+            if(content.contains("<!DOCTYPE TS>")){
+                cFileMode = FileModeTS;
+            } else if(content.contains("<!DOCTYPE QPH>")){
+                cFileMode = FileModeQPH;
+            }
+            if(fileMode == FileModeUndefined && cFileMode != FileModeUndefined)
+                fileMode = cFileMode;
+
+            if(cFileMode == FileModeUndefined){
+                emit error("The file type could not be determand!");
+                return false;
+            } else {
+                if(fileMode != cFileMode){
+                    emit error("Error: Mixed *.ts and *.qph files!");
+                    return false;
+                }
+            }
+
+            //Language always follows the DOCTYPE
+            int index(0);
+            if(cFileMode == FileModeQPH){
+                //not ts file check for source language
+
+                QRegExp regEx("<QPH sourcelanguage=\"(.*)\"");
+                regEx.setMinimal(true);
+                index = regEx.indexIn(content);
+                if(index <0){
+                    emit error("Parse error of target file!");
+                    return false;
+                }
+
+                QString language = content.mid(index + 21, 5);
+                if(languageSource.isEmpty())
+                    languageSource = language;
+                else if(languageSource != language){
+                    emit error(tr("Source languages do not match!"));
+                    return false;
+                }
+            }
+
+            QRegExp regEx("language=\"(.*)\"");
+            regEx.setMinimal(true);
+            index = regEx.indexIn(content, index + 21);
+            if(index <0){
+                emit error("Parse error of target file!");
+                return false;
+            }
+            QString language = content.mid(index + 10, 5);
+            if(languageTarget.isEmpty())
+                languageTarget = language;
+            else if(languageTarget != language){
+                emit error(tr("Targeted languages do not match!"));
+                return false;
+            }
+        }
+    }
+
+    //error handling
+    if(fileMode == FileModeUndefined){
+        emit error("The file type could not be determand!");
+        return false;
+    }
+
+    if(languageTarget.isEmpty()){
+        emit error("Targeted language could not be determind!");
+        return false;
+    }
+
+    if(languageSource.isEmpty())
+        languageSource = sourceLanguage;
+    //Determined source and target languages need to match the target file languages
+    QFile readFile(PhrasebookShards::headerFileName(targetPhrasebook.toLocalFile()));
+    if(readFile.open(QIODevice::ReadOnly)){
+        QString content = readFile.readAll();
+        readFile.close();
+
+        if(!content.contains("<!DOCTYPE QPH>")){
+            emit error(tr("Target file is not a phrasebook!"));
+            return false;
+        }
+
+        //Source language of target
+        QRegExp regEx("<QPH sourcelanguage=\"(.*)\"");
+        regEx.setMinimal(true);
+        int index = regEx.indexIn(content);
+        if(index <0){
+            emit error("Parse error of target file!");
+            return false;
+        }
+        QString language = content.mid(index + 21, 5);
+        if(languageSource.isEmpty())
+            languageSource = language;
+        else if(languageSource != language){
+            emit error(tr("Source languages do not match!"));
+            return false;
+        }
+
+        //target language of target
+        regEx.setPattern("language=\"(.*)\"");
+        index = regEx.indexIn(content, index + 21);
+        if(index <0){
+            emit error("Parse error of target file!");
+            return false;
+        }
+        language = content.mid(index + 10, 5);
+        if(language != languageTarget){
+            emit error(tr("Targeted language does not match with the others!"));
+            return false;
+        }
+    }
+    return true;
+}
+
+void PhrasebookMaker::addUpdatePhrases(PhraseCollection &collection, const QList<QUrl> &sources, const QUrl &targetPhrasebook, int fileMode,
+                                       QVector<QPair<QUrl, QVector<Phrase>>> *added)
+{
+    for(const QUrl &url : sources){
+        const QVector<Phrase> phrasesFromSourceFile = fileMode == FileModeQPH ?
+                    phrasesFromPhrasebook(url) :
+                    parseSingleTsFile(url, targetPhrasebook.fileName().split(".").first());
+
+        //Subsets will be empty for FileModeQPH
+        const int existing = collection.size();
+        addUniquePhrases(collection, phrasesFromSourceFile, url);
+        if(added)
+            added->append(qMakePair(url, collection.phrases().mid(existing)));
+    }
+}
+
+void PhrasebookMaker::addUniquePhrases(PhraseCollection &collection, const QVector<Phrase> &phrases, const QUrl &origin)
+{
+    addUniquePhrases(collection, phrases, m_stats);
+    addConflicts(phrases, origin);
+}
+
+void PhrasebookMaker::addUniquePhrases(PhraseCollection &collection, const QVector<Phrase> &phrases, RunStatistics &stats)
+{
+    for(const Phrase &p : phrases){
+        if(!collection.insert(p))
+            stats.duplicatesDropped++;
+
+        for(const Phrase & subset : p.oldSources()){
+            stats.oldSourceExpansions++;
+            if(!collection.insert(subset))
+                stats.duplicatesDropped++;
+        }
+    }
+}
+
+void PhrasebookMaker::addConflicts(const QVector<Phrase> &phrases, const QUrl &origin)
+{
+    //Conflict resolution needs every occurrence, not only the unique ones
+    if(m_conflictPolicy == ConflictIndex::KeepAll)
+        return;
+
+    const QString file = origin.toLocalFile();
+    const qint64 fileModified = QFileInfo(file).lastModified().toMSecsSinceEpoch();
+    for(const Phrase &p : phrases){
+        m_conflicts.add(p, file, fileModified);
+        for(const Phrase & subset : p.oldSources())
+            m_conflicts.add(subset, file, fileModified);
+    }
+}
+
+QVector<Phrase> PhrasebookMaker::resolveConflicts(const QVector<Phrase> &phrases)
+{
+    if(m_conflictPolicy == ConflictIndex::KeepAll)
+        return phrases;
+
+    int dropped(0);
+    const QVector<Phrase> resolved = m_conflicts.resolve(phrases, m_conflictPolicy, &dropped);
+    m_stats.conflictsResolved += dropped;
+    return resolved;
+}
+
+bool PhrasebookMaker::writePhrasebook(const QString &fileName, const QString &sourceLanguage, const QString &targetLanguage, const QVector<Phrase> &phrases)
+{
+    if(m_options.testFlag(ShardedOutput) || PhrasebookShards::isIndexFile(fileName))
+        return writeShardedPhrasebook(fileName, sourceLanguage, targetLanguage, phrases);
+    return writePhrasebookFile(fileName, sourceLanguage, targetLanguage, phrases);
+}
+
+bool PhrasebookMaker::writePhrasebookFile(const QString &fileName, const QString &sourceLanguage, const QString &targetLanguage, const QVector<Phrase> &phrases)
+{
+    const bool canonical = m_options.testFlag(CanonicalOutput);
+
+    //Canonical output does not depend on the order the phrases were collected in
+    QVector<Phrase> sortedPhrases;
+    if(canonical){
+        sortedPhrases = phrases;
+        parallelSort(sortedPhrases, [](const Phrase &a, const Phrase &b) -> bool { return a < b; });
+    }
+    const QVector<Phrase> &output = canonical ? sortedPhrases : phrases;
+
+    QSaveFile newPhrasebook(fileName);
+    if(!newPhrasebook.open(QIODevice::WriteOnly)) {
+        reportError(tr("Could not create file"));
+        return false;
+    }
+
+    //Same encoding a QTextStream would use, but with known byte offsets for the index.
+    //Phrases are stored as UTF-8, so with a UTF-8 locale they are written without any conversion
+    QTextCodec *codec = QTextCodec::codecForLocale();
+    const bool utf8 = codec->mibEnum() == 106;
+    QVector<qint64> offsets;
+    QVector<Phrase> indexedPhrases;
+    qint64 offset(0);
+
+    //Header
+    const QString header = QString("<!DOCTYPE QPH>\n<QPH sourcelanguage=\"%1\" language=\"%2\">\n").arg(sourceLanguage).arg(targetLanguage);
+    offset += newPhrasebook.write(codec->fromUnicode(header));
+
+    for(const Phrase &p : output){
+        if(!p.isValid())
+            continue;
+
+        if(canonical){
+            offsets << offset;
+            indexedPhrases << p;
+        }
+        offset += newPhrasebook.write(utf8 ? p.toXmlUtf8() : codec->fromUnicode(p.toXml()));
+    }
+
+    offset += newPhrasebook.write(codec->fromUnicode(QStringLiteral("</QPH>\n")));
+    m_stats.bytesWritten += offset;
+
+    if(!newPhrasebook.commit()){
+        reportError(tr("Could not save changes"));
+        return false;
+    }
+    m_stats.filesWritten++;
+
+    //Lookup sidecars only for canonical output, otherwise "Patch Ts File" computes the filter on its first parse
+    if(canonical){
+        PhrasebookIndex::write(fileName, offsets, indexedPhrases);
+
+        PhrasebookFilter filter;
+        filter.build(output);
+        filter.save(fileName);
+    } else {
+        PhrasebookIndex::remove(fileName);
+        QFile::remove(PhrasebookFilter::filterFileName(fileName));
+    }
+    return true;
+}
+
+bool PhrasebookMaker::writeShardedPhrasebook(const QString &fileName, const QString &sourceLanguage, const QString &targetLanguage, const QVector<Phrase> &phrases)
+{
+    const QString indexFile = PhrasebookShards::indexFileName(fileName);
+
+    //Shards of an earlier write with more shards are removed once the new index is in place
+    PhrasebookShards previous;
+    const QStringList previousFiles = previous.load(indexFile) ? previous.shardFiles() : QStringList();
+
+    //Every shard is a complete phrasebook with its own *.idx and *.bloom
+    const QVector<QVector<Phrase>> shards = PhrasebookShards::split(phrases, m_shardCount, m_normalization);
+    QVector<int> phraseCounts;
+    for(int i(0); i < shards.size(); i++){
+        if(!writePhrasebookFile(PhrasebookShards::shardFileName(indexFile, i), sourceLanguage, targetLanguage, shards.at(i)))
+            return false;
+        phraseCounts << shards.at(i).size();
+    }
+
+    PhrasebookShards index;
+    if(!index.save(indexFile, sourceLanguage, targetLanguage, m_normalization, phraseCounts)){
+        reportError(tr("Could not save the shard index"));
+        return false;
+    }
+
+    QStringList staleFiles;
+    for(const QString &shard : previousFiles){
+        if(!index.shardFiles().contains(shard))
+            staleFiles << shard;
+    }
+    //A phrasebook written to the same name before is replaced by the shards
+    if(indexFile != fileName)
+        staleFiles << fileName;
+
+    for(const QString &stale : qAsConst(staleFiles)){
+        QFile::remove(stale);
+        PhrasebookIndex::remove(stale);
+        QFile::remove(PhrasebookFilter::filterFileName(stale));
+    }
+    return true;
+}
+
+QString PhrasebookMaker::outputFileName(const QString &fileName) const
+{
+    if(m_options.testFlag(ShardedOutput))
+        return PhrasebookShards::indexFileName(fileName);
+    return fileName;
+}
+
+bool PhrasebookMaker::appendToPhrasebook(const QString &fileName, const QVector<Phrase> &phrases)
+{
+    QFile phrasebook(fileName);
+    if(!phrasebook.open(QIODevice::ReadWrite)){
+        emit error(tr("Target file could not be opened!"));
+        return false;
+    }
+
+    //Locate the closing tag, it is the last thing in the file
+    const qint64 tailSize = qMin<qint64>(phrasebook.size(), 64);
+    phrasebook.seek(phrasebook.size() - tailSize);
+    const QByteArray tail = phrasebook.read(tailSize);
+    const int closingTag = tail.lastIndexOf("</QPH>");
+    if(closingTag < 0){
+        emit error("Parse error of target file!");
+        return false;
+    }
+    const qint64 insert = phrasebook.size() - tailSize + closingTag;
+
+    QByteArray journal;
+    QTextStream writeStream(&journal);
+    writeStream << JournalMarker << endl;
+    for(const Phrase &p : phrases){
+        writeStream << p;
+    }
+    writeStream.flush();
+    const QByteArray closing("</QPH>\n");
+
+    //The segment replaces the closing tag, which is written again only after the segment reached the file.
+    //On any failure the original tail is restored. A crash between both writes still leaves the phrasebook
+    //without its closing tag. Phrases are read entry by entry, so it stays readable and Compact Phrasebook repairs it
+    const bool written = phrasebook.seek(insert) && phrasebook.write(journal) == journal.size() && phrasebook.flush()
+            && phrasebook.write(closing) == closing.size() && phrasebook.flush()
+            && phrasebook.resize(insert + journal.size() + closing.size());
+    if(!written){
+        const QByteArray originalTail = tail.mid(closingTag);
+        if(!phrasebook.seek(insert) || phrasebook.write(originalTail) != originalTail.size() || !phrasebook.flush()
+                || !phrasebook.resize(insert + originalTail.size()))
+            emit error(tr("Could not save changes, the phrasebook lost its closing tag. Run Compact Phrasebook to repair it"));
+        else
+            emit error(tr("Could not save changes"));
+        return false;
+    }
+    m_stats.bytesWritten += journal.size() + closing.size();
+    m_stats.filesWritten++;
+    return true;
+}
+
+bool PhrasebookMaker::writeSpilledPhrasebook(const QString &fileName, ExternalDeduplicator &deduplicator)
+{
+    QSaveFile newPhrasebook(fileName);
+    if(!newPhrasebook.open(QIODevice::WriteOnly)) {
+        emit error(tr("Could not create file"));
+        return false;
+    }
+
+    QTextCodec *codec = QTextCodec::codecForLocale();
+    const bool utf8 = codec->mibEnum() == 106;
+    qint64 written(0);
+
+    const QString header = QString("<!DOCTYPE QPH>\n<QPH sourcelanguage=\"%1\" language=\"%2\">\n").arg(m_sourceLanguage).arg(m_targetLanguage);
+    written += newPhrasebook.write(codec->fromUnicode(header));
+
+    //The merge already delivers the phrases sorted by source and target
+    const bool merged = deduplicator.merge([&newPhrasebook, codec, utf8, &written](const Phrase &p){
+        if(p.isValid())
+            written += newPhrasebook.write(utf8 ? p.toXmlUtf8() : codec->fromUnicode(p.toXml()));
+        return newPhrasebook.error() == QFileDevice::NoError;
+    });
+
+    m_stats.uniquePhrases += deduplicator.uniquePhrases();
+    m_stats.duplicatesDropped += deduplicator.duplicatesDropped();
+    m_stats.conflictsResolved += deduplicator.conflictsResolved();
+
+    if(!merged){
+        newPhrasebook.cancelWriting();
+        emit error(deduplicator.errorString().isEmpty() ? tr("Could not save changes") : deduplicator.errorString());
+        return false;
+    }
+
+    written += newPhrasebook.write(codec->fromUnicode(QStringLiteral("</QPH>\n")));
+    m_stats.bytesWritten += written;
+
+    if(!newPhrasebook.commit()){
+        emit error(tr("Could not save changes"));
+        return false;
+    }
+    m_stats.filesWritten++;
+
+    //Both sidecars would need every phrase in memory, a missing filter is rebuilt on the next parse
+    PhrasebookIndex::remove(fileName);
+    QFile::remove(PhrasebookFilter::filterFileName(fileName));
+    return true;
+}
+
+void PhrasebookMaker::patchTsFileFromPhrasebooks(const QList<QUrl> &sourcesQph, const QUrl &targetTsFile)
+{
+    /*
+    Steps:
+    - Check sources are qph files
+    - check target *ts lanugage matches all languages inside the phrasebook files
+    - Parse targetTS extract all phrases, subset untranslated phrases
+    - Parse source qph extract all phrases and check each against untranslated phrases
+        When translation found, add it, add type tag "unfinished" move it to all phrases
+        continue untill subset empty or all sources parsed
+    */
+
+    m_stats.clear();
+    m_stats.startPhase(QStringLiteral("validate"));
+
+    //Id TS target languagse
+    const QString targetLanguage = tsLanguage(targetTsFile.toLocalFile());
+    if(targetLanguage.isEmpty()){
+        emit error(tr("Could not id targeted language!"));
+        return;
+    }
+
+    //Checks done update section
+    m_stats.startPhase(QStringLiteral("parse target"));
+    m_progress.reset();
+    m_progress.addToTotal(QFileInfo(targetTsFile.toLocalFile()).size());
+    for(const QUrl &url : sourcesQph)
+        m_progress.addToTotal(QFileInfo(url.toLocalFile()).size());
+
+    //Only the untranslated messages are of interest, everything else is never decoded
+    const QVector<LazyPhrase> phrasesFromTs = lazyPhrasesFromTsFile(targetTsFile);
+    QVector<Phrase> notTranslatedPhrases;
+    QVector<Phrase> nowTranslatedPhrases;
+
+    for(const LazyPhrase &p : phrasesFromTs)
+            if(!p.hasTranslation() && (p.type() != Phrase::Vanished && p.type() != Phrase::Obsolete))
+                notTranslatedPhrases << Phrase(p.source(), QString(), p.definition(), p.type());
+
+    if(notTranslatedPhrases.isEmpty()){
+        emit error(tr("No untranslated phrases in the ts file!"));
+        return;
+    }
+
+
+    for(const QUrl &url : sourcesQph){
+        if(!isPhrasebook(url.fileName())){
+            emit error(tr("Please select only phrasebook files"));
+            return;
+        }
+
+        QString targetLangPb, errorMessage;
+        if(!phrasebookLanguage(url.toLocalFile(), targetLangPb, errorMessage)){
+            emit error(errorMessage);
+            return;
+        }
+        if(targetLangPb != targetLanguage){
+            emit error(tr("Phrasebook targets a different language compared to the *.ts file!"));
+            return;
+        }
+    }
+
+    //Of a sharded phrasebook only the shards that can hold one of the untranslated sources are looked up
+    QList<QUrl> phrasebooks;
+    for(const QUrl &url : sourcesQph){
+        if(!PhrasebookShards::isIndexFile(url.toLocalFile())){
+            phrasebooks << url;
+            continue;
+        }
+
+        PhrasebookShards shards;
+        if(!shards.load(url.toLocalFile())){
+            emit error(tr("Could not read the shard index!"));
+            return;
+        }
+        const QVector<int> needed = shards.shardsFor(notTranslatedPhrases, m_normalization);
+        m_stats.filesSkipped += shards.shardCount() - needed.size();
+        for(int shard : needed){
+            phrasebooks << QUrl::fromLocalFile(shards.shardFile(shard));
+            m_progress.addToTotal(QFileInfo(shards.shardFile(shard)).size());
+        }
+    }
+
+    m_stats.startPhase(QStringLiteral("lookup"));
+    for(const QUrl &url : qAsConst(phrasebooks)){
+        //Phrasebooks that can not contain any of the sources are skipped without parsing them.
+        //Filter and index hold the exact sources, they can not be used for normalized matching
+        const bool exactMatching = m_normalization == Normalizer::NoNormalization;
+        PhrasebookFilter filter;
+        if(exactMatching && filter.load(url.toLocalFile())){
+            bool possibleHit(false);
+            for(const Phrase &tsPhrase : qAsConst(notTranslatedPhrases)){
+                if(filter.mayContain(tsPhrase.source())){
+                    possibleHit = true;
+                    break;
+                }
+            }
+            if(!possibleHit){
+                m_stats.filesSkipped++;
+                m_progress.advance(QFileInfo(url.toLocalFile()).size());
+                continue;
+            }
+        }
+
+        //Canonical phrasebooks can be binary searched, as long as only a few lookups are needed
+        PhrasebookIndex index;
+        const bool useIndex = exactMatching && index.open(url.toLocalFile()) && notTranslatedPhrases.size() < index.size() / 16;
+
+        //First translation of a source wins
+        QHash<QString, QString> translations;
+        if(useIndex){
+            m_progress.advance(QFileInfo(url.toLocalFile()).size());
+        } else {
+            const QVector<Phrase> phrases = phrasesFromPhrasebook(url);
+            addTranslations(translations, phrases, m_normalization);
+
+            //Computed on first load, used by the next patch
+            if(exactMatching && !filter.isValid()){
+                filter.build(phrases);
+                filter.save(url.toLocalFile());
+            }
+        }
+
+        for(int i(notTranslatedPhrases.size() - 1); i >= 0; i--){
+            Phrase &tsPhrase = notTranslatedPhrases[i];
+
+            //Saves the disk reads of the binary search for sources that are not in the phrasebook
+            if(useIndex && filter.isValid() && !filter.mayContain(tsPhrase.source()))
+                continue;
+
+            QString translation;
+            if(useIndex){
+                for(const Phrase &qphPhrase : index.find(tsPhrase.source())){
+                    if(qphPhrase.hasTranslation()){
+                        translation = qphPhrase.target();
+                        break;
+                    }
+                }
+            } else {
+                translation = translations.value(tsPhrase.matchKey(m_normalization));
+            }
+
+            if(!translation.isEmpty()){
+                tsPhrase.setTranslation(translation);
+                nowTranslatedPhrases << tsPhrase;
+                notTranslatedPhrases.remove(i);
+            }
+        }
+
+        if(notTranslatedPhrases.isEmpty()){
+            //all translations done -> break early
+            break;
+        }
+    }
+    m_progress.finish();
+
+    if(nowTranslatedPhrases.isEmpty()){
+        emit error(tr("No new translations were found!"));
+        return;
+    }
+
+    // a Ts file can be much more complex and contain more information than the Phrase class can currently map to
+    //Therefore the file is copied as is and only the translation elements of the patched messages are replaced
+
+    m_stats.startPhase(QStringLiteral("write"));
+    QHash<QString, QString> translations;
+    translations.reserve(nowTranslatedPhrases.size());
+    for(const Phrase &p : qAsConst(nowTranslatedPhrases))
+        translations.insert(p.matchKey(m_normalization), p.target());
+
+    QString errorMessage;
+    if(!patchTsFileWithTranslations(targetTsFile.toLocalFile(), translations, m_normalization, m_stats, nullptr, errorMessage)){
+        emit error(errorMessage);
+        return;
+    }
+
+    finishRun();
+    emit success();
+}
+
+namespace {
+struct PatchJob
+{
+    QString fileName;
+    QString language;
+
+    bool ok = false;
+    QString errorMessage;
+    RunStatistics stats;
+};
+}
+
+void PhrasebookMaker::patchTsFilesFromPhrasebooks(const QList<QUrl> &sourcesQph, const QList<QUrl> &targetTsFiles)
+{
+    /*
+    Steps:
+    - Group the phrasebooks by their target language
+    - Id the language of every target *.ts file
+    - Parse each needed phrasebook once and index it by source, per language
+    - Patch all targets in parallel, each one with its own QSaveFile
+    */
+
+    m_stats.clear();
+    m_stats.startPhase(QStringLiteral("validate"));
+    m_progress.reset();
+
+    if(targetTsFiles.isEmpty()){
+        emit error(tr("No files selected"));
+        return;
+    }
+
+    QHash<QString, QList<QUrl>> phrasebooksByLanguage;
+    for(const QUrl &url : sourcesQph){
+        if(!isPhrasebook(url.fileName())){
+            emit error(tr("Please select only phrasebook files"));
+            return;
+        }
+
+        QString language, errorMessage;
+        if(!phrasebookLanguage(url.toLocalFile(), language, errorMessage)){
+            emit error(errorMessage);
+            return;
+        }
+        phrasebooksByLanguage[language].append(url);
+    }
+
+    //A checkpoint of the targets, a rerun with the same unchanged phrasebooks skips the patched ones.
+    //Phrasebooks are identified by their content, shards of a *.qphs count as phrasebooks of their own
+    QStringList inputs, phrasebooks;
+    for(const QUrl &url : targetTsFiles)
+        inputs << url.toLocalFile();
+    for(const QUrl &url : sourcesQph){
+        QStringList files{url.toLocalFile()};
+        PhrasebookShards shards;
+        if(PhrasebookShards::isIndexFile(url.toLocalFile()) && shards.load(url.toLocalFile()))
+            files << shards.shardFiles();
+
+        for(const QString &file : qAsConst(files)){
+            const QFileInfo info(file);
+            phrasebooks << QStringLiteral("%1:%2:%3").arg(info.absoluteFilePath()).arg(info.size())
+                           .arg(QString::fromLatin1(ExportManifest::fileHash(file).toHex()));
+        }
+    }
+    BatchManifest batch(QStringLiteral("patch ts files"), inputs, batchSettings(phrasebooks.join(',')));
+    batch.load();
+
+    QStringList errors;
+    QVector<PatchJob> jobs;
+    QStringList languages;
+    for(const QUrl &url : targetTsFiles){
+        if(batch.isDone(url.toLocalFile())){
+            m_stats.filesSkipped++;
+            continue;
+        }
+
+        const QString language = tsLanguage(url.toLocalFile());
+        if(language.isEmpty()){
+            errors << QStringLiteral("%1: %2").arg(url.fileName(), tr("Could not id targeted language!"));
+            batch.markFailed(url.toLocalFile(), errors.last());
+            continue;
+        }
+        if(!phrasebooksByLanguage.contains(language)){
+            errors << QStringLiteral("%1: %2").arg(url.fileName(), tr("No phrasebook targets the language %1").arg(language));
+            batch.markFailed(url.toLocalFile(), errors.last());
+            continue;
+        }
+
+        PatchJob job;
+        job.fileName = url.toLocalFile();
+        job.language = language;
+        jobs << job;
+
+        if(!languages.contains(language))
+            languages << language;
+        m_progress.addToTotal(QFileInfo(job.fileName).size());
+    }
+    for(const QString &language : qAsConst(languages)){
+        for(const QUrl &url : phrasebooksByLanguage.value(language))
+            m_progress.addToTotal(QFileInfo(url.toLocalFile()).size());
+    }
+
+    //One parse per phrasebook, shared by all targets of the same language
+    m_stats.startPhase(QStringLiteral("index phrasebooks"));
+    QHash<QString, QHash<QString, QString>> translationsByLanguage;
+    for(const QString &language : qAsConst(languages)){
+        QHash<QString, QString> &translations = translationsByLanguage[language];
+        for(const QUrl &url : phrasebooksByLanguage.value(language))
+            addTranslations(translations, phrasesFromPhrasebook(url), m_normalization);
+    }
+
+    m_stats.startPhase(QStringLiteral("patch"));
+    const QHash<QString, QHash<QString, QString>> &indexes = translationsByLanguage;
+    const Normalizer::Steps normalization = m_normalization;
+    ProgressReporter *progress = &m_progress;
+    //The checkpoint is saved as soon as a target is done, an interrupted run keeps the finished ones
+    QMutex batchMutex;
+    QtConcurrent::blockingMap(jobs, [&indexes, normalization, progress, &batch, &batchMutex](PatchJob &job){
+        job.ok = patchTsFileWithTranslations(job.fileName, indexes.constFind(job.language).value(), normalization,
+                                             job.stats, progress, job.errorMessage);
+
+        QMutexLocker locker(&batchMutex);
+        if(job.ok)
+            batch.markDone(job.fileName, job.fileName);
+        else
+            batch.markFailed(job.fileName, job.errorMessage);
+        batch.save();
+    });
+
+    for(const PatchJob &job : qAsConst(jobs)){
+        m_stats.merge(job.stats);
+        if(!job.ok)
+            errors << QStringLiteral("%1: %2").arg(QFileInfo(job.fileName).fileName(), job.errorMessage);
+    }
+
+    if(errors.isEmpty())
+        batch.remove();
+    else
+        batch.save();
+
+    m_progress.finish();
+    finishRun();
+
+    if(!errors.isEmpty()){
+        emit error(errors.join('\n'));
+        return;
+    }
+    emit success();
+}
+
+namespace {
+struct SelfPatchJob
+{
+    QString fileName;
+    QString language;
+
+    QString data;
+    QVector<LazyPhrase> messages;
+
+    bool ok = false;
+    QString errorMessage;
+    RunStatistics stats;
+};
+}
+
+void PhrasebookMaker::selfPatchTsFiles(const QList<QUrl> &tsFiles)
+{
+    /*
+    Steps:
+    - Read and scan every *.ts file once, in parallel
+    - Index the finished messages by source, per language and in the order of the files
+    - Patch the untranslated messages of every file from the index of its language, in parallel,
+      from the already scanned content
+    */
+
+    m_stats.clear();
+    m_stats.startPhase(QStringLiteral("validate"));
+    m_progress.reset();
+
+    if(tsFiles.isEmpty()){
+        emit error(tr("No files selected"));
+        return;
+    }
+
+    QStringList errors;
+    QVector<SelfPatchJob> jobs;
+    for(const QUrl &url : tsFiles){
+        if(!url.fileName().endsWith(QStringLiteral(".ts"))){
+            emit error(tr("Please select only translation files"));
+            return;
+        }
+
+        const QString language = tsLanguage(url.toLocalFile());
+        if(language.isEmpty()){
+            errors << QStringLiteral("%1: %2").arg(url.fileName(), tr("Could not id targeted language!"));
+            continue;
+        }
+
+        SelfPatchJob job;
+        job.fileName = url.toLocalFile();
+        job.language = language;
+        jobs << job;
+
+        //Scanned and patched
+        m_progress.addToTotal(2 * QFileInfo(job.fileName).size());
+    }
+
+    m_stats.startPhase(QStringLiteral("scan"));
+    ProgressReporter *progress = &m_progress;
+    QtConcurrent::blockingMap(jobs, [progress](SelfPatchJob &job){
+        job.ok = readTsData(job.fileName, job.data, job.stats, job.errorMessage);
+        if(job.ok){
+            job.messages = LazyPhrase::fromTsData(job.data);
+            job.stats.messagesParsed += job.messages.size();
+        }
+        progress->advance(QFileInfo(job.fileName).size());
+    });
+
+    m_stats.startPhase(QStringLiteral("index"));
+    QHash<QString, QHash<QString, QString>> translationsByLanguage;
+    for(const SelfPatchJob &job : qAsConst(jobs)){
+        if(job.ok)
+            addFinishedTranslations(translationsByLanguage[job.language], job.messages, m_normalization);
+    }
+
+    m_stats.startPhase(QStringLiteral("patch"));
+    const QHash<QString, QHash<QString, QString>> &indexes = translationsByLanguage;
+    const Normalizer::Steps normalization = m_normalization;
+    QtConcurrent::blockingMap(jobs, [&indexes, normalization, progress](SelfPatchJob &job){
+        const qint64 fileSize = QFileInfo(job.fileName).size();
+        if(job.ok){
+            job.ok = patchTsDataWithTranslations(job.fileName, job.data, job.messages, indexes.constFind(job.language).value(),
+                                                 normalization, job.stats, job.errorMessage);
+        }
+        job.messages.clear();
+        job.data.clear();
+        progress->advance(fileSize);
+    });
+
+    for(const SelfPatchJob &job : qAsConst(jobs)){
+        m_stats.merge(job.stats);
+        if(!job.ok)
+            errors << QStringLiteral("%1: %2").arg(QFileInfo(job.fileName).fileName(), job.errorMessage);
+    }
+
+    m_progress.finish();
+    finishRun();
+
+    if(!errors.isEmpty()){
+        emit error(errors.join('\n'));
+        return;
+    }
+    emit success();
+}
+
+bool PhrasebookMaker::isPhrasebook(const QString &fileName)
+{
+    return fileName.endsWith(QStringLiteral(".qph")) || PhrasebookShards::isIndexFile(fileName);
+}
+
+QString PhrasebookMaker::tsLanguage(const QString &fileName)
+{
+    bool isTsFile(false);
+    QString targetLanguage;
+    QFile f(fileName);
+    if(f.open(QIODevice::ReadOnly)){
+        QTextStream readStream(&f);
+
+        while(!readStream.atEnd()){
+            QString line = readStream.readLine();
+
+            if(!isTsFile && line.contains("<!DOCTYPE TS>")){
+                isTsFile = true;
+            }
+
+            if(line.contains("language=\"")){
+                const QString searchStr("language=\"");
+                int i= line.indexOf(searchStr);
+                targetLanguage = line.mid(i + searchStr.length(), 5);
+            }
+            if(isTsFile && !targetLanguage.isEmpty())
+                //All needed information acquiered
+                break;
+        }
+        f.close();
+    }
+    return targetLanguage;
+}
+
+bool PhrasebookMaker::phrasebookLanguage(const QString &fileName, QString &language, QString &errorMessage)
+{
+    QFile readFile(PhrasebookShards::headerFileName(fileName));
+    if(!readFile.open(QIODevice::ReadOnly)){
+        errorMessage = tr("Could not open phrasebook!");
+        return false;
+    }
+
+    //Header is at the very beginning of the file
+    QString data = readFile.read(1024);
+    QRegExp regEx("<QPH sourcelanguage=\"(.*)\"");
+    regEx.setMinimal(true);
+    int index = regEx.indexIn(data);
+    if(index <0){
+        errorMessage = tr("Parse error of target file!");
+        return false;
+    }
+
+    regEx.setPattern("language=\"(.*)\"");
+    index = regEx.indexIn(data, index + 21);
+    if(index < 0){
+        errorMessage = tr("Parse error of target file!");
+        return false;
+    }
+
+    language = data.mid(index + 10, 5);
+    return true;
+}
+
+void PhrasebookMaker::addTranslations(QHash<QString, QString> &translations, const QVector<Phrase> &phrases, Normalizer::Steps normalization)
+{
+    //First translation of a source wins
+    translations.reserve(translations.size() + phrases.size());
+    for(const Phrase &p : phrases){
+        if(p.hasTranslation() && !translations.contains(p.matchKey(normalization)))
+            translations.insert(p.matchKey(normalization), p.target());
+    }
+}
+
+bool PhrasebookMaker::patchTsFileWithTranslations(const QString &fileName, const QHash<QString, QString> &translations,
+                                                  Normalizer::Steps normalization, RunStatistics &stats, ProgressReporter *progress, QString &errorMessage)
+{
+    const qint64 fileSize = QFileInfo(fileName).size();
+    QString data;
+    if(!readTsData(fileName, data, stats, errorMessage))
+        return false;
+
+    const QVector<LazyPhrase> messages = LazyPhrase::fromTsData(data);
+    stats.messagesParsed += messages.size();
+
+    const bool patched = patchTsDataWithTranslations(fileName, data, messages, translations, normalization, stats, errorMessage);
+    if(progress)
+        progress->advance(fileSize);
+    return patched;
+}
+
+bool PhrasebookMaker::readTsData(const QString &fileName, QString &data, RunStatistics &stats, QString &errorMessage)
+{
+    QFile readTsFile(fileName);
+    if(!readTsFile.open(QIODevice::ReadOnly)){
+        errorMessage = tr("Ts file could not be read or written to");
+        return false;
+    }
+    QTextStream readStream(&readTsFile);
+    data = readStream.readAll();
+
+    //The file is closed on return, before any QSaveFile commits onto it
+    stats.bytesRead += readTsFile.size();
+    stats.filesRead++;
+    return true;
+}
+
+void PhrasebookMaker::addFinishedTranslations(QHash<QString, QString> &translations, const QVector<LazyPhrase> &messages,
+                                              Normalizer::Steps normalization)
+{
+    //Finished messages have no type, first translation of a source wins
+    for(const LazyPhrase &message : messages){
+        if(!message.hasTranslation() || message.type() != Phrase::None)
+            continue;
+
+        const QString key = Normalizer::normalized(message.source(), normalization);
+        if(!translations.contains(key))
+            translations.insert(key, message.target());
+    }
+}
+
+bool PhrasebookMaker::patchTsDataWithTranslations(const QString &fileName, const QString &data, const QVector<LazyPhrase> &messages,
+                                                  const QHash<QString, QString> &translations, Normalizer::Steps normalization,
+                                                  RunStatistics &stats, QString &errorMessage)
+{
+    //Everything is copied unchanged, except the translation elements of the patched messages
+    QString patched;
+    patched.reserve(data.size() + data.size() / 8);
+    int copied(0);
+    int hits(0);
+
+    for(const LazyPhrase &message : messages){
+        if(message.hasTranslation() || message.type() == Phrase::Vanished || message.type() == Phrase::Obsolete
+                || message.translationElementBegin() < 0)
+            continue;
+
+        const auto translation = translations.constFind(Normalizer::normalized(message.source(), normalization));
+        if(translation == translations.constEnd()){
+            stats.patchMisses++;
+            continue;
+        }
+
+        patched.append(data.midRef(copied, message.translationElementBegin() - copied));
+        patched.append(QStringLiteral("<translation type=\"unfinished\">"));
+        patched.append(XmlCodec::escaped(translation.value()));
+        patched.append(QStringLiteral("</translation>"));
+        copied = message.translationElementEnd();
+        hits++;
+    }
+    patched.append(data.midRef(copied));
+    stats.patchHits += hits;
+
+    if(hits == 0){
+        //Nothing to patch, leave the file untouched
+        return true;
+    }
+
+    QSaveFile writeTsFile(fileName);
+    if(!writeTsFile.open(QIODevice::WriteOnly)){
+        errorMessage = tr("Ts file could not be read or written to");
+        return false;
+    }
+
+    QTextStream writeStream(&writeTsFile);
+    writeStream << patched;
+    writeStream.flush();
+    stats.bytesWritten += writeTsFile.size();
+
+    if(!writeTsFile.commit()){
+        errorMessage = tr("Could not save changes");
+        return false;
+    }
+    stats.filesWritten++;
+    return true;
+}
+
+bool PhrasebookMaker::checkLanguages(const QUrl &url)
+{
+    QString sourceLangPb;
+    QString targetLangPb;
+    QFile readFile(url.toLocalFile());
+    if(!readFile.fileName().endsWith(".qph")){
+        emit error(tr("Not supported file format!"));
+        return false;
+    }
+    if(!readFile.exists() || !readFile.open(QIODevice::ReadOnly)){
+        emit error(tr("Target file could not be opened!"));
+        return false;
+    }
+    QString data = readFile.readAll();
+    QRegExp regEx("<QPH sourcelanguage=\"(.*)\"");
+    regEx.setMinimal(true);
+    int index = regEx.indexIn(data);
+    if(index <0){
+        emit error("Parse error of target file!");
+        return false;
+    }
+    
+    sourceLangPb = data.mid(index + 21,5);
+    regEx.setPattern("language=\"(.*)\"");
+    index = regEx.indexIn(data, index + 21);
+    if(index < 0){
+        emit error("Parseerror of target file!");
+        return false;
+    }
+    
+    targetLangPb = data.mid(index + 10, 5);
+
+    if(targetLangPb != m_targetLanguage || m_sourceLanguage != sourceLangPb){
+        emit error(tr("Language missmatch"));
+        return false;
+    }
+    return  true;
+}
+
+void PhrasebookMaker::init(const QList<QUrl> &sources, const QString sourceLanguage)
+{
+    m_sourceLanguage = sourceLanguage;
+
+    m_progress.reset();
+    for(const QUrl &url :sources )
+        m_progress.addToTotal(QFileInfo(url.toLocalFile()).size());
+}
+
+bool PhrasebookMaker::preprocessSources(const QList<QUrl> &sources)
+{
+    m_targetLanguage.clear();
+
+    if(sources.isEmpty()){
+        reportError(tr("No files selected"));
+        return false;
+    }
+
+    for(const QUrl &url :sources ){
+        if(!url.isValid()){
+            reportError(tr("Invalid file path!"));
+            return false;
+        }
+
+        if(!url.fileName().endsWith(".ts")){
+            reportError(tr("Invalid file format"));
+            return  false;
+        }
+
+        QFile readFile(url.toLocalFile());
+
+        if(readFile.size() > 209715200) {
+            reportError(tr("File size exeeds reasonable limit of 200 mb"));
+            return false;
+        }
+
+        if(!readFile.exists() || !readFile.open(QIODevice::ReadOnly)){
+            reportError(tr("File does not exist or could not be opend!"));
+            return false;
+        }
+
+        QTextStream stream(&readFile);
+        bool isTsFile(false);
+        QString language;
+
+        while(!stream.atEnd()){
+            QString line = stream.readLine();
+
+            if(!isTsFile && line.contains("<!DOCTYPE TS>")){
+                isTsFile = true;
+            }
+
+            if(line.contains("language=\"")){
+                const QString searchStr("language=\"");
+                int i= line.indexOf(searchStr);
+                language = line.mid(i + searchStr.length(), 5);
+                if(m_targetLanguage.isEmpty())
+                    m_targetLanguage = language;
+                else if(m_targetLanguage != language){
+                    reportError("Selected files target different languages!");
+                    return false;
+                }
+
+            }
+            if(isTsFile && !language.isEmpty())
+                //All needed information acquiered: break from while -> next file in list
+                break;
+        }
+
+        if(!isTsFile){
+            reportError(tr("Invalid file format"));
+            return  false;
+        }
+
+        if(language.isEmpty()){
+            reportError(tr("*ts file has no language defined"));
+            return false;
+        }
+    }
+    return true;
+}
+
+QVector<Phrase> PhrasebookMaker::phrasesFromPhrasebook(const QUrl &url, int *journalSegments)
+{
+    if(PhrasebookShards::isIndexFile(url.toLocalFile())){
+        //Shards are rewritten as a whole, they never hold journal segments
+        if(journalSegments)
+            *journalSegments = 0;
+
+        PhrasebookShards shards;
+        if(!shards.load(url.toLocalFile())){
+            emit error(tr("Could not read the shard index!"));
+            return QVector<Phrase>();
+        }
+
+        QVector<Phrase> phrases;
+        for(int i(0); i < shards.shardCount(); i++){
+            if(shards.phraseCount(i) == 0)
+                continue;
+            m_progress.addToTotal(QFileInfo(shards.shardFile(i)).size());
+            phrases += phrasesFromPhrasebook(QUrl::fromLocalFile(shards.shardFile(i)));
+        }
+        return phrases;
+    }
+
+    QVector<Phrase> phrases;
+    QFile file(url.toLocalFile());
+
+    //Phrasebooks are written with the locale codec, when it is UTF-8 the bytes are parsed directly
+    const bool utf8 = QTextCodec::codecForLocale()->mibEnum() == 106;
+
+    if(utf8 && file.exists() && file.open(QIODevice::ReadOnly)){
+        const QByteArray data = file.readAll();
+        if(journalSegments)
+            *journalSegments = data.count(JournalMarker.toUtf8());
+
+        const QByteArray open("<phrase>"), close("</phrase>");
+        int index(0);
+        while(true){
+            const int begin = data.indexOf(open, index);
+            if(begin < 0)
+                break;
+            const int end = data.indexOf(close, begin);
+            if(end < 0)
+                break;
+
+            phrases.append(Phrase::fromPhrasebookEntry(data, begin, end + close.size()));
+            m_stats.phrasesParsed++;
+
+            m_progress.advance(end + close.size() - index);
+            index = end + close.size();
+        }
+        m_progress.advance(data.size() - index);
+
+        m_stats.bytesRead += file.size();
+        m_stats.filesRead++;
+    } else if(file.exists() && file.open(QIODevice::ReadOnly)){
+        QTextStream readStream(&file);
+        QString data = readStream.readAll();
+        if(readStream.status() == QTextStream::Ok){
+            if(journalSegments)
+                *journalSegments = data.count(JournalMarker);
+
+            QRegExp phraseReg("<phrase>(.*)</phrase>");
+            phraseReg.setMinimal(true);
+
+            int index (0);
+            qint64 reported(0);
+
+            while (true) {
+                index = phraseReg.indexIn(data, index);
+                if(index >= 0){
+                    QString section = data.mid(index, phraseReg.matchedLength());
+                    phrases.append(Phrase(section));
+                    m_stats.phrasesParsed++;
+                } else {
+                    break;
+                }
+                index += phraseReg.matchedLength();
+
+                //Map the position inside the decoded text back onto the file size
+                const qint64 reached = file.size() * index / data.size();
+                m_progress.advance(reached - reported);
+                reported = reached;
+            }
+            m_progress.advance(file.size() - reported);
+        }
+        m_stats.bytesRead += file.size();
+        m_stats.filesRead++;
+    }
+    if(phrases.isEmpty())
+        emit error("Phrases could not be extracted!");
+
+    return phrases;
+}
+
+QVector<Phrase> PhrasebookMaker::parseSingleTsFile(const QUrl &url, const QString &defaultName,
+                                                   const ContextCache *previousContexts, ContextCache *currentContexts)
+{
+    return parseTsFile(url, defaultName, previousContexts, currentContexts, m_stats, &m_progress);
+}
+
+QVector<Phrase> PhrasebookMaker::parseTsFile(const QUrl &url, const QString &defaultName, const ContextCache *previousContexts,
+                                             ContextCache *currentContexts, RunStatistics &stats, ProgressReporter *progress)
+{
+    QVector<Phrase> phrases;
+
+    QFile readFile(url.toLocalFile());
+    readFile.open(QIODevice::ReadOnly);
+
+    QTextStream readStream(&readFile);
+
+    QString data = readStream.readAll();
+
+    QRegExp contextReg("<context>(.*)</context>");
+    contextReg.setMinimal(true);
+
+    int index (0);
+    qint64 reported(0);
+    while (true) {
+        index = contextReg.indexIn(data, index);
+        if(index >= 0){
+            QString section = data.mid(index, contextReg.matchedLength());
+
+            //Unchanged context -> reuse the phrases from the previous run
+            QByteArray contextKey;
+            if(currentContexts){
+                contextKey = ExportManifest::contextHash(defaultName, section);
+                if(previousContexts && previousContexts->contains(contextKey)){
+                    const QVector<Phrase> cached = previousContexts->value(contextKey);
+                    phrases += cached;
+                    currentContexts->insert(contextKey, cached);
+                    stats.contextsReused++;
+
+                    index += contextReg.matchedLength();
+                    const qint64 reached = readFile.size() * index / data.size();
+                    progress->advance(reached - reported);
+                    reported = reached;
+                    continue;
+                }
+            }
+
+            stats.contextsParsed++;
+            QString name = QString(" ") + Phrase::infoFromSection(section,"name");
+
+            QRegExp messageReg("<message>(.*)</message>");
+            messageReg.setMinimal(true);
+
+            QVector<Phrase> contextPhrases;
+            int indexMessage(0);
+            while(true){
+                indexMessage = messageReg.indexIn(section,indexMessage);
+                if(indexMessage > 0){
+                    contextPhrases.append(Phrase(section.mid(indexMessage, messageReg.matchedLength()), defaultName + name));
+                    stats.messagesParsed++;
+                } else {
+                    break;
+                }
+                indexMessage += messageReg.matchedLength();
+            }
+            phrases += contextPhrases;
+            if(currentContexts)
+                currentContexts->insert(contextKey, contextPhrases);
+        } else {
+            break;
+        }
+        index += contextReg.matchedLength();
+
+        //Map the position inside the decoded text back onto the file size
+        const qint64 reached = readFile.size() * index / data.size();
+        progress->advance(reached - reported);
+        reported = reached;
+    }
+    progress->advance(readFile.size() - reported);
+
+    stats.bytesRead += readFile.size();
+    stats.filesRead++;
+
+    return phrases;
+}
+
+QVector<LazyPhrase> PhrasebookMaker::lazyPhrasesFromTsFile(const QUrl &url, const QString &defaultName)
+{
+    QFile readFile(url.toLocalFile());
+    if(!readFile.open(QIODevice::ReadOnly))
+        return QVector<LazyPhrase>();
+
+    QTextStream readStream(&readFile);
+    const QString data = readStream.readAll();
+
+    const QVector<LazyPhrase> phrases = LazyPhrase::fromTsData(data, defaultName);
+    m_stats.messagesParsed += phrases.size();
+    m_stats.bytesRead += readFile.size();
+    m_stats.filesRead++;
+    m_progress.advance(readFile.size());
+
+    return phrases;
+}
+
+void PhrasebookMaker::finishRun()
+{
+    m_stats.finish();
+    emit statisticsAvailable(m_stats);
+}
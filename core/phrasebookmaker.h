@@ -0,0 +1,169 @@
+#ifndef PHRASEBOOKMAKER_H
+#define PHRASEBOOKMAKER_H
+
+#include "phrasebookcore_global.h"
+
+#include <QHash>
+#include <QObject>
+#include <QStringList>
+#include <QUrl>
+
+#include "conflictindex.h"
+#include "exportmanifest.h"
+#include "normalizer.h"
+#include "progressreporter.h"
+#include "runstatistics.h"
+
+class ExternalDeduplicator;
+class LazyPhrase;
+class Phrase;
+class PhraseCollection;
+class PHRASEBOOKCORE_EXPORT PhrasebookMaker : public QObject
+{
+    Q_OBJECT
+public:
+    enum Option {
+        NoOptions = 0x0,
+        IncrementalExport = 0x1,    //Skip exports whose inputs did not change, reuse unchanged contexts
+        CanonicalOutput = 0x2,      //Sort phrasebooks by definition, source and target and write a *.idx sidecar
+        OutOfCoreExport = 0x4,      //Deduplicate "Export to Target" through sorted runs on disk, see ExternalDeduplicator
+        LockedUpdate = 0x8,         //"Update Phrasebook" locks the target while committing and merges changes of other processes
+        SkipFailingFiles = 0x10,    //Batch runs record failing files in their checkpoint and continue with the next one
+        ShardedOutput = 0x20        //Written phrasebooks are split into shards with a *.qphs index, see PhrasebookShards
+    };
+    Q_DECLARE_FLAGS(Options, Option)
+    Q_FLAG(Options)
+
+    explicit PhrasebookMaker(QObject *parent = nullptr);
+
+    inline Options options() const {return m_options;}
+    void setOptions(Options options);
+
+    //Memory used for buffered phrases before an out-of-core export spills them to disk
+    inline qint64 memoryBudget() const {return m_memoryBudget;}
+    void setMemoryBudget(qint64 bytes);
+
+    //Number of *.qph files a sharded phrasebook is split into
+    inline int shardCount() const {return m_shardCount;}
+    void setShardCount(int count);
+
+    inline ConflictIndex::Policy conflictPolicy() const {return m_conflictPolicy;}
+    void setConflictPolicy(ConflictIndex::Policy policy);
+
+    //Matching keys used by deduplication and patching
+    inline Normalizer::Steps normalization() const {return m_normalization;}
+    void setNormalization(Normalizer::Steps normalization);
+
+    void exportFilesToSingleNewPhrasebook(const QList<QUrl> &sources, const QUrl &destination, const QString &sourceLanguage);
+    void exportFilesToNewPhrasebooks(const QList<QUrl> &sources, const QString &sourceLanguage);
+
+    void updatePhrasebookFromFiles(const QList<QUrl> &sources, const QUrl &targetPhrasebook, const QString &sourceLanguage);
+    void appendToPhrasebookFromFiles(const QList<QUrl> &sources, const QUrl &targetPhrasebook, const QString &sourceLanguage);
+    void compactPhrasebook(const QUrl &phrasebook);
+    void exportPhrasebooksToLookupTables(const QList<QUrl> &phrasebooks);
+
+    void reportConflicts(const QList<QUrl> &sources, const QUrl &report);
+    void validateTranslations(const QList<QUrl> &sources, const QUrl &report);
+    void analyzeFrequencies(const QList<QUrl> &sources, const QUrl &report);
+    void clusterSimilarSources(const QList<QUrl> &sources, const QUrl &report);
+    void patchTsFileFromPhrasebooks(const QList<QUrl> &sourcesQph, const QUrl &targetTsFile);
+    void patchTsFilesFromPhrasebooks(const QList<QUrl> &sourcesQph, const QList<QUrl> &targetTsFiles);
+    //Fills untranslated messages from finished messages with the same source, across all files of the same language
+    void selfPatchTsFiles(const QList<QUrl> &tsFiles);
+
+signals:
+    void error(const QString &error);
+
+    void progressMaximum(int maximum);
+    void progressValue(int value);
+
+    void success();
+    void statisticsAvailable(const RunStatistics &statistics);
+
+    void newlyCreatedFiles(const QList<QUrl> &url);
+
+private:
+    bool checkLanguages(const QUrl &url);
+    void init(const QList<QUrl> &sources, const QString sourceLanguage);
+    bool preprocessSources(const QList<QUrl> &sources);
+    //Errors of preprocessSources and writePhrasebook, collected instead of emitted during a batch export
+    void reportError(const QString &message);
+
+    //One file of "Export to new Phrasebooks", outputFile is set once it is known
+    bool exportToNewPhrasebook(const QUrl &url, QList<QUrl> &createdFiles, QString &outputFile);
+    //Identifies a BatchManifest together with its inputs
+    QString batchSettings(const QString &extra) const;
+    //Settings that change the written phrasebooks, part of every manifest key
+    QString outputSettings() const;
+
+    bool validateUpdateSources(const QList<QUrl> &sources, const QUrl &targetPhrasebook, const QString &sourceLanguage,
+                               int &fileMode, QString &languageSource, QString &languageTarget);
+    void addUpdatePhrases(PhraseCollection &collection, const QList<QUrl> &sources, const QUrl &targetPhrasebook, int fileMode,
+                          QVector<QPair<QUrl, QVector<Phrase>>> *added = nullptr);
+    void addUniquePhrases(PhraseCollection &collection, const QVector<Phrase> &phrases, const QUrl &origin = QUrl());
+    //Thread safe, old sources are expanded, conflicts are not tracked
+    static void addUniquePhrases(PhraseCollection &collection, const QVector<Phrase> &phrases, RunStatistics &stats);
+    void addConflicts(const QVector<Phrase> &phrases, const QUrl &origin);
+    QVector<Phrase> resolveConflicts(const QVector<Phrase> &phrases);
+
+    //Writes the shards and *.qphs index instead, with ShardedOutput or for an index file name
+    bool writePhrasebook(const QString &fileName, const QString &sourceLanguage, const QString &targetLanguage, const QVector<Phrase> &phrases);
+    bool writePhrasebookFile(const QString &fileName, const QString &sourceLanguage, const QString &targetLanguage, const QVector<Phrase> &phrases);
+    bool writeShardedPhrasebook(const QString &fileName, const QString &sourceLanguage, const QString &targetLanguage, const QVector<Phrase> &phrases);
+    //The file a write of fileName actually creates
+    QString outputFileName(const QString &fileName) const;
+    bool appendToPhrasebook(const QString &fileName, const QVector<Phrase> &phrases);
+    //Streams the merged runs into the phrasebook, no *.idx or *.bloom is written
+    bool writeSpilledPhrasebook(const QString &fileName, ExternalDeduplicator &deduplicator);
+
+    QVector<Phrase> phrasesFromPhrasebook(const QUrl &url, int *journalSegments = nullptr);
+    QVector<Phrase> parseSingleTsFile(const QUrl &url, const QString &defaultName = QString(),
+                                      const ContextCache *previousContexts = nullptr, ContextCache *currentContexts = nullptr);
+    //Thread safe, does not emit any signal
+    static QVector<Phrase> parseTsFile(const QUrl &url, const QString &defaultName, const ContextCache *previousContexts,
+                                       ContextCache *currentContexts, RunStatistics &stats, ProgressReporter *progress);
+    QVector<LazyPhrase> lazyPhrasesFromTsFile(const QUrl &url, const QString &defaultName = QString());
+
+    static QString tsLanguage(const QString &fileName);
+    //*.qph or a *.qphs shard index
+    static bool isPhrasebook(const QString &fileName);
+    static bool phrasebookLanguage(const QString &fileName, QString &language, QString &errorMessage);
+
+    //Keyed by the normalized source
+    static void addTranslations(QHash<QString, QString> &translations, const QVector<Phrase> &phrases, Normalizer::Steps normalization);
+    //Thread safe, does not emit any signal
+    static bool patchTsFileWithTranslations(const QString &fileName, const QHash<QString, QString> &translations,
+                                            Normalizer::Steps normalization, RunStatistics &stats, ProgressReporter *progress, QString &errorMessage);
+    static bool readTsData(const QString &fileName, QString &data, RunStatistics &stats, QString &errorMessage);
+    static void addFinishedTranslations(QHash<QString, QString> &translations, const QVector<LazyPhrase> &messages, Normalizer::Steps normalization);
+    //Splices the translations into already scanned content and writes it, the file is left untouched without hits
+    static bool patchTsDataWithTranslations(const QString &fileName, const QString &data, const QVector<LazyPhrase> &messages,
+                                            const QHash<QString, QString> &translations, Normalizer::Steps normalization,
+                                            RunStatistics &stats, QString &errorMessage);
+
+    void finishRun();
+
+protected:
+    QString m_targetLanguage;
+    QString m_sourceLanguage;
+
+    ProgressReporter m_progress;
+
+    Options m_options = NoOptions;
+    qint64 m_memoryBudget = Q_INT64_C(256) * 1024 * 1024;
+    int m_shardCount = 16;
+
+    ConflictIndex::Policy m_conflictPolicy = ConflictIndex::KeepAll;
+    Normalizer::Steps m_normalization = Normalizer::NoNormalization;
+    ConflictIndex m_conflicts;
+
+    RunStatistics m_stats;
+
+private:
+    QStringList *m_collectedErrors = nullptr;
+
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(PhrasebookMaker::Options)
+
+#endif // PHRASEBOOKMAKER_H
@@ -0,0 +1,190 @@
+#include "phrasebookshards.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+
+const int ShardIndexVersion(1);
+
+namespace {
+quint64 fnv1a(const QByteArray &data)
+{
+    quint64 h = Q_UINT64_C(14695981039346656037);
+    for(const char c : data){
+        h ^= static_cast<uchar>(c);
+        h *= Q_UINT64_C(1099511628211);
+    }
+    return h;
+}
+
+QString shardPath(const QString &indexFile, const QString &shardFile)
+{
+    return QFileInfo(indexFile).dir().filePath(shardFile);
+}
+}
+
+PhrasebookShards::PhrasebookShards()
+{
+
+}
+
+bool PhrasebookShards::isIndexFile(const QString &fileName)
+{
+    return fileName.endsWith(QStringLiteral(".qphs"));
+}
+
+QString PhrasebookShards::indexFileName(const QString &phrasebook)
+{
+    if(isIndexFile(phrasebook))
+        return phrasebook;
+    if(phrasebook.endsWith(QStringLiteral(".qph")))
+        return phrasebook + QLatin1Char('s');
+    return phrasebook + QStringLiteral(".qphs");
+}
+
+QString PhrasebookShards::shardFileName(const QString &indexFile, int shard)
+{
+    const QString base = indexFile.left(indexFile.size() - 5);
+    return QStringLiteral("%1.%2.qph").arg(base, QString::number(shard).rightJustified(2, QLatin1Char('0')));
+}
+
+QString PhrasebookShards::headerFileName(const QString &phrasebook)
+{
+    return isIndexFile(phrasebook) ? shardFileName(phrasebook, 0) : phrasebook;
+}
+
+int PhrasebookShards::shardOf(const QString &key, int shardCount)
+{
+    return static_cast<int>(fnv1a(key.toUtf8()) % static_cast<quint64>(shardCount));
+}
+
+QVector<QVector<Phrase>> PhrasebookShards::split(const QVector<Phrase> &phrases, int shardCount, Normalizer::Steps normalization)
+{
+    QVector<QVector<Phrase>> shards(shardCount);
+    for(QVector<Phrase> &shard : shards)
+        shard.reserve(phrases.size() / shardCount + 1);
+
+    for(const Phrase &p : phrases)
+        shards[shardOf(p.matchKey(normalization), shardCount)] << p;
+    return shards;
+}
+
+bool PhrasebookShards::save(const QString &indexFile, const QString &sourceLanguage, const QString &targetLanguage,
+                            Normalizer::Steps normalization, const QVector<int> &phraseCounts)
+{
+    m_indexFile = indexFile;
+    m_sourceLanguage = sourceLanguage;
+    m_targetLanguage = targetLanguage;
+    m_normalization = static_cast<int>(normalization);
+
+    m_shards.clear();
+    QJsonArray shards;
+    for(int i(0); i < phraseCounts.size(); i++){
+        const QFileInfo info(shardFileName(indexFile, i));
+        Shard shard;
+        shard.fileName = info.fileName();
+        shard.size = info.size();
+        shard.modified = info.lastModified().toMSecsSinceEpoch();
+        shard.phrases = phraseCounts.at(i);
+        m_shards << shard;
+
+        QJsonObject entry;
+        entry.insert("file", shard.fileName);
+        entry.insert("size", static_cast<double>(shard.size));
+        entry.insert("modified", static_cast<double>(shard.modified));
+        entry.insert("phrases", shard.phrases);
+        shards.append(entry);
+    }
+
+    QJsonObject root;
+    root.insert("version", ShardIndexVersion);
+    root.insert("hash", QStringLiteral("fnv1a64"));
+    root.insert("sourceLanguage", sourceLanguage);
+    root.insert("language", targetLanguage);
+    root.insert("normalization", m_normalization);
+    root.insert("shards", shards);
+
+    QSaveFile file(indexFile);
+    if(!file.open(QIODevice::WriteOnly))
+        return false;
+    file.write(QJsonDocument(root).toJson());
+    return file.commit();
+}
+
+bool PhrasebookShards::load(const QString &indexFile)
+{
+    m_shards.clear();
+
+    QFile file(indexFile);
+    if(!file.open(QIODevice::ReadOnly))
+        return false;
+
+    const QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+    if(root.value("version").toInt() != ShardIndexVersion)
+        return false;
+
+    m_indexFile = indexFile;
+    m_sourceLanguage = root.value("sourceLanguage").toString();
+    m_targetLanguage = root.value("language").toString();
+    m_normalization = root.value("normalization").toInt();
+
+    const QJsonArray shards = root.value("shards").toArray();
+    for(const QJsonValue &value : shards){
+        const QJsonObject entry = value.toObject();
+        Shard shard;
+        shard.fileName = entry.value("file").toString();
+        shard.size = static_cast<qint64>(entry.value("size").toDouble(-1));
+        shard.modified = static_cast<qint64>(entry.value("modified").toDouble(-1));
+        shard.phrases = entry.value("phrases").toInt();
+        m_shards << shard;
+    }
+    return !m_shards.isEmpty();
+}
+
+QString PhrasebookShards::shardFile(int shard) const
+{
+    return shardPath(m_indexFile, m_shards.at(shard).fileName);
+}
+
+QStringList PhrasebookShards::shardFiles() const
+{
+    QStringList files;
+    for(const Shard &shard : m_shards)
+        files << shardPath(m_indexFile, shard.fileName);
+    return files;
+}
+
+bool PhrasebookShards::isUnchanged() const
+{
+    for(const Shard &shard : m_shards){
+        const QFileInfo info(shardPath(m_indexFile, shard.fileName));
+        if(info.size() != shard.size || info.lastModified().toMSecsSinceEpoch() != shard.modified)
+            return false;
+    }
+    return true;
+}
+
+QVector<int> PhrasebookShards::shardsFor(const QVector<Phrase> &phrases, Normalizer::Steps normalization) const
+{
+    QVector<int> selected;
+    if(static_cast<int>(normalization) != m_normalization || !isUnchanged()){
+        for(int i(0); i < m_shards.size(); i++)
+            selected << i;
+        return selected;
+    }
+
+    QVector<bool> needed(m_shards.size(), false);
+    for(const Phrase &p : phrases)
+        needed[shardOf(p.matchKey(normalization), m_shards.size())] = true;
+
+    for(int i(0); i < needed.size(); i++){
+        if(needed.at(i) && m_shards.at(i).phrases > 0)
+            selected << i;
+    }
+    return selected;
+}
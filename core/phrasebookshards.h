@@ -0,0 +1,69 @@
+#ifndef PHRASEBOOKSHARDS_H
+#define PHRASEBOOKSHARDS_H
+
+#include "phrasebookcore_global.h"
+#include "normalizer.h"
+#include "phrase.h"
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+//A large phrasebook split into complete *.qph files by a stable hash of the matching key, so Linguist
+//and lookups only load parts of it. The index <name>.qphs lists the shards <name>.<n>.qph with their state.
+//A sharded phrasebook is addressed by its index
+class PHRASEBOOKCORE_EXPORT PhrasebookShards
+{
+public:
+    PhrasebookShards();
+
+    static bool isIndexFile(const QString &fileName);
+    //app.qph -> app.qphs
+    static QString indexFileName(const QString &phrasebook);
+    //app.qphs -> app.03.qph
+    static QString shardFileName(const QString &indexFile, int shard);
+    //A *.qph that starts with the same header, the first shard for an index
+    static QString headerFileName(const QString &phrasebook);
+
+    //FNV-1a over the UTF-8 key, stable across platforms and runs
+    static int shardOf(const QString &key, int shardCount);
+    //Keeps the order of the phrases inside each shard
+    static QVector<QVector<Phrase>> split(const QVector<Phrase> &phrases, int shardCount, Normalizer::Steps normalization);
+
+    //Records the current state of the already written shards
+    bool save(const QString &indexFile, const QString &sourceLanguage, const QString &targetLanguage,
+              Normalizer::Steps normalization, const QVector<int> &phraseCounts);
+    bool load(const QString &indexFile);
+
+    inline int shardCount() const {return m_shards.size();}
+    inline QString sourceLanguage() const {return m_sourceLanguage;}
+    inline QString targetLanguage() const {return m_targetLanguage;}
+    inline int phraseCount(int shard) const {return m_shards.at(shard).phrases;}
+    QString shardFile(int shard) const;
+    QStringList shardFiles() const;
+
+    //False once a shard was edited or replaced outside of the maker, its phrases may then be in any shard
+    bool isUnchanged() const;
+
+    //Shards that can hold a translation for one of the phrases, all of them when the keys are not comparable
+    QVector<int> shardsFor(const QVector<Phrase> &phrases, Normalizer::Steps normalization) const;
+
+private:
+    struct Shard
+    {
+        QString fileName;
+        qint64 size = -1;
+        qint64 modified = -1;
+        int phrases = 0;
+    };
+
+private:
+    QString m_indexFile;
+    QString m_sourceLanguage;
+    QString m_targetLanguage;
+    int m_normalization = 0;
+
+    QVector<Shard> m_shards;
+};
+
+#endif // PHRASEBOOKSHARDS_H
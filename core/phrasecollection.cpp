@@ -0,0 +1,45 @@
+#include "phrasecollection.h"
+
+PhraseCollection::PhraseCollection(Normalizer::Steps normalization) : m_normalization(normalization)
+{
+
+}
+
+void PhraseCollection::reserve(int size)
+{
+    m_phrases.reserve(size);
+    if(m_normalization == Normalizer::NoNormalization)
+        m_keys.reserve(size);
+    else
+        m_normalizedKeys.reserve(size);
+}
+
+bool PhraseCollection::insert(const Phrase &phrase)
+{
+    if(m_normalization == Normalizer::NoNormalization){
+        if(m_keys.contains(phrase))
+            return false;
+        m_keys.insert(phrase);
+    } else {
+        const QString key = normalizedKey(phrase);
+        if(m_normalizedKeys.contains(key))
+            return false;
+        m_normalizedKeys.insert(key);
+    }
+
+    m_phrases.append(phrase);
+    return true;
+}
+
+bool PhraseCollection::contains(const Phrase &phrase) const
+{
+    if(m_normalization == Normalizer::NoNormalization)
+        return m_keys.contains(phrase);
+    return m_normalizedKeys.contains(normalizedKey(phrase));
+}
+
+QString PhraseCollection::normalizedKey(const Phrase &phrase) const
+{
+    //Only the source is normalized, translations that differ in case or accelerators are kept apart
+    return phrase.matchKey(m_normalization) + QChar(0x1f) + phrase.target();
+}
@@ -0,0 +1,38 @@
+#ifndef PHRASECOLLECTION_H
+#define PHRASECOLLECTION_H
+
+#include "phrasebookcore_global.h"
+#include "phrase.h"
+
+#include <QSet>
+#include <QVector>
+
+//Keeps phrases unique (by source and target) in the order they were first seen.
+//With normalization, phrases with the same normalized source and the same target count as duplicates
+class PHRASEBOOKCORE_EXPORT PhraseCollection
+{
+public:
+    explicit PhraseCollection(Normalizer::Steps normalization = Normalizer::NoNormalization);
+
+    void reserve(int size);
+
+    //Returns false if an equal phrase already exists
+    bool insert(const Phrase &phrase);
+
+    bool contains(const Phrase &phrase) const;
+    inline int size() const {return m_phrases.size();}
+    inline bool isEmpty() const {return m_phrases.isEmpty();}
+
+    inline const QVector<Phrase> &phrases() const {return m_phrases;}
+
+private:
+    QString normalizedKey(const Phrase &phrase) const;
+
+private:
+    Normalizer::Steps m_normalization;
+    QVector<Phrase> m_phrases;
+    QSet<Phrase> m_keys;
+    QSet<QString> m_normalizedKeys;
+};
+
+#endif // PHRASECOLLECTION_H
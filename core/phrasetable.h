@@ -0,0 +1,130 @@
+#ifndef PHRASETABLE_H
+#define PHRASETABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+//Read-only view of a compiled phrasebook (*.qpt), as written by PhraseTableWriter.
+//Header only and without Qt: the file can be mmap'ed and used as is, nothing is parsed or allocated.
+//
+//Layout, all integers are 32 bit little endian:
+//  header  "QPHT", version, phrase count n, bucket count r, blob size
+//  seeds   r displacement seeds, one per bucket
+//  slots   n times source offset, source size, target offset, target size
+//  blob    UTF-8 strings, each one followed by a 0 byte
+//The slot of a source is displace(hash(source), seeds[bucket(hash(source))]) % n,
+//the stored source is compared, because unknown sources end up in arbitrary slots.
+class PhraseTable
+{
+public:
+    static const uint32_t Version = 1;
+    static const size_t HeaderSize = 20;
+    static const size_t SlotSize = 16;
+
+    PhraseTable() {}
+    PhraseTable(const void *data, size_t size) {open(data, size);}
+
+    //The data has to stay valid as long as the table is used
+    bool open(const void *data, size_t size)
+    {
+        *this = PhraseTable();
+
+        const unsigned char *bytes = static_cast<const unsigned char *>(data);
+        if(!bytes || size < HeaderSize || std::memcmp(bytes, "QPHT", 4) != 0 || read32(bytes + 4) != Version)
+            return false;
+
+        const uint32_t count = read32(bytes + 8);
+        const uint32_t buckets = read32(bytes + 12);
+        const uint32_t blobSize = read32(bytes + 16);
+        if(HeaderSize + uint64_t(buckets) * 4 + uint64_t(count) * SlotSize + blobSize != size || (count > 0 && buckets == 0))
+            return false;
+
+        m_count = count;
+        m_buckets = buckets;
+        m_blobSize = blobSize;
+        m_seeds = bytes + HeaderSize;
+        m_slots = m_seeds + size_t(buckets) * 4;
+        m_blob = m_slots + size_t(count) * SlotSize;
+        return true;
+    }
+
+    inline bool isValid() const {return m_seeds != nullptr;}
+    inline uint32_t size() const {return m_count;}
+
+    //0 terminated UTF-8 translation of the UTF-8 source, nullptr if the source is unknown
+    const char *find(const char *source, size_t length, uint32_t *targetSize = nullptr) const
+    {
+        if(m_count == 0)
+            return nullptr;
+
+        const uint64_t h = hash(source, length);
+        const uint32_t seed = read32(m_seeds + 4 * (bucket(h, m_buckets)));
+        const unsigned char *slot = m_slots + SlotSize * slotIndex(h, seed, m_count);
+
+        const uint32_t sourceOffset = read32(slot);
+        const uint32_t sourceSize = read32(slot + 4);
+        const uint32_t targetOffset = read32(slot + 8);
+        const uint32_t size = read32(slot + 12);
+        if(sourceSize != length || uint64_t(sourceOffset) + sourceSize > m_blobSize || uint64_t(targetOffset) + size >= m_blobSize)
+            return nullptr;
+        if(std::memcmp(m_blob + sourceOffset, source, length) != 0)
+            return nullptr;
+
+        if(targetSize)
+            *targetSize = size;
+        return reinterpret_cast<const char *>(m_blob + targetOffset);
+    }
+
+    inline const char *find(const char *source) const {return find(source, std::strlen(source));}
+
+    //Shared with the writer, changing any of these requires a new Version
+
+    //64 bit FNV-1a
+    static uint64_t hash(const char *data, size_t length)
+    {
+        uint64_t h = 14695981039346656037ULL;
+        for(size_t i = 0; i < length; i++){
+            h ^= static_cast<unsigned char>(data[i]);
+            h *= 1099511628211ULL;
+        }
+        return h;
+    }
+
+    static inline uint32_t bucket(uint64_t hash, uint32_t buckets)
+    {
+        return static_cast<uint32_t>(mix(hash) % buckets);
+    }
+
+    static inline uint32_t slotIndex(uint64_t hash, uint32_t seed, uint32_t count)
+    {
+        return static_cast<uint32_t>(mix(hash ^ ((uint64_t(seed) + 1) * 0x9E3779B97F4A7C15ULL)) % count);
+    }
+
+private:
+    //Murmur3 finalizer
+    static inline uint64_t mix(uint64_t k)
+    {
+        k ^= k >> 33;
+        k *= 0xFF51AFD7ED558CCDULL;
+        k ^= k >> 33;
+        k *= 0xC4CEB3F99ABD9C53ULL;
+        k ^= k >> 33;
+        return k;
+    }
+
+    static inline uint32_t read32(const unsigned char *p)
+    {
+        return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+    }
+
+private:
+    uint32_t m_count = 0;
+    uint32_t m_buckets = 0;
+    uint32_t m_blobSize = 0;
+    const unsigned char *m_seeds = nullptr;
+    const unsigned char *m_slots = nullptr;
+    const unsigned char *m_blob = nullptr;
+};
+
+#endif // PHRASETABLE_H
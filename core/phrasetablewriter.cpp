@@ -0,0 +1,133 @@
+#include "phrasetablewriter.h"
+#include "phrasetable.h"
+
+#include <QDataStream>
+#include <QFileInfo>
+#include <QHash>
+#include <QSaveFile>
+
+#include <algorithm>
+
+QString PhraseTableWriter::tableFileName(const QString &phrasebook)
+{
+    const QFileInfo info(phrasebook);
+    return info.path() + QChar('/') + info.completeBaseName() + QStringLiteral(".qpt");
+}
+
+bool PhraseTableWriter::write(const QString &fileName, const QVector<Phrase> &phrases, QString &errorMessage, int *written)
+{
+    //Unique sources in order of appearance
+    QVector<QByteArray> sources;
+    QVector<QByteArray> targets;
+    QHash<QByteArray, int> known;
+    for(const Phrase &phrase : phrases){
+        if(!phrase.hasTranslation())
+            continue;
+        const QByteArray source = phrase.sourceUtf8();
+        if(known.contains(source))
+            continue;
+        known.insert(source, sources.size());
+        sources << source;
+        targets << phrase.targetUtf8();
+    }
+
+    //Hash and displace: big buckets first, each one gets the first seed that moves all its sources into free slots
+    const quint32 count = static_cast<quint32>(sources.size());
+    const quint32 bucketCount = qMax<quint32>(1, (count + 3) / 4);
+
+    QVector<quint64> hashes(sources.size());
+    QVector<QVector<int>> buckets(static_cast<int>(bucketCount));
+    for(int i(0); i < sources.size(); i++){
+        hashes[i] = PhraseTable::hash(sources.at(i).constData(), static_cast<size_t>(sources.at(i).size()));
+        buckets[static_cast<int>(PhraseTable::bucket(hashes.at(i), bucketCount))].append(i);
+    }
+
+    QVector<int> order(buckets.size());
+    for(int i(0); i < order.size(); i++)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&buckets](int a, int b){
+        return buckets.at(a).size() > buckets.at(b).size();
+    });
+
+    const quint64 maxSeed = qMax<quint64>(1 << 20, quint64(count) * 64);
+    QVector<quint32> seeds(buckets.size(), 0);
+    QVector<int> slots(static_cast<int>(count), -1);
+    QVector<quint32> candidate;
+    for(int b : qAsConst(order)){
+        const QVector<int> &bucket = buckets.at(b);
+        if(bucket.isEmpty())
+            break;
+
+        bool placed(false);
+        for(quint64 seed(0); seed < maxSeed && !placed; seed++){
+            candidate.clear();
+            placed = true;
+            for(int i : bucket){
+                const quint32 slot = PhraseTable::slotIndex(hashes.at(i), static_cast<quint32>(seed), count);
+                if(slots.at(static_cast<int>(slot)) >= 0 || candidate.contains(slot)){
+                    placed = false;
+                    break;
+                }
+                candidate << slot;
+            }
+            if(placed){
+                seeds[b] = static_cast<quint32>(seed);
+                for(int i(0); i < bucket.size(); i++)
+                    slots[static_cast<int>(candidate.at(i))] = bucket.at(i);
+            }
+        }
+
+        if(!placed){
+            errorMessage = tr("Could not build the lookup table, no perfect hash was found!");
+            return false;
+        }
+    }
+
+    //Identical strings are stored only once
+    QByteArray blob;
+    QHash<QByteArray, quint32> offsets;
+    auto store = [&blob, &offsets](const QByteArray &string) -> quint32 {
+        auto it = offsets.constFind(string);
+        if(it != offsets.constEnd())
+            return it.value();
+        const quint32 offset = static_cast<quint32>(blob.size());
+        blob.append(string);
+        blob.append('\0');
+        offsets.insert(string, offset);
+        return offset;
+    };
+
+    QVector<quint32> slotData;
+    slotData.reserve(static_cast<int>(count) * 4);
+    for(int i : qAsConst(slots)){
+        const quint32 sourceOffset = store(sources.at(i));
+        const quint32 targetOffset = store(targets.at(i));
+        slotData << sourceOffset << static_cast<quint32>(sources.at(i).size())
+                 << targetOffset << static_cast<quint32>(targets.at(i).size());
+    }
+
+    QSaveFile file(fileName);
+    if(!file.open(QIODevice::WriteOnly)){
+        errorMessage = tr("Lookup table could not be created!");
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream.writeRawData("QPHT", 4);
+    stream << static_cast<quint32>(PhraseTable::Version) << count << bucketCount << static_cast<quint32>(blob.size());
+    for(quint32 seed : qAsConst(seeds))
+        stream << seed;
+    for(quint32 value : qAsConst(slotData))
+        stream << value;
+    stream.writeRawData(blob.constData(), blob.size());
+
+    if(stream.status() != QDataStream::Ok || !file.commit()){
+        errorMessage = tr("Lookup table could not be written!");
+        return false;
+    }
+
+    if(written)
+        *written = static_cast<int>(count);
+    return true;
+}
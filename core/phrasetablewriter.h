@@ -0,0 +1,23 @@
+#ifndef PHRASETABLEWRITER_H
+#define PHRASETABLEWRITER_H
+
+#include "phrasebookcore_global.h"
+#include "phrase.h"
+
+#include <QCoreApplication>
+#include <QString>
+#include <QVector>
+
+//Compiles phrases into a *.qpt lookup table, see phrasetable.h for the format and the reader
+class PHRASEBOOKCORE_EXPORT PhraseTableWriter
+{
+    Q_DECLARE_TR_FUNCTIONS(PhraseTableWriter)
+
+public:
+    static QString tableFileName(const QString &phrasebook);
+
+    //Untranslated phrases are skipped, the first translation of a source wins
+    static bool write(const QString &fileName, const QVector<Phrase> &phrases, QString &errorMessage, int *written = nullptr);
+};
+
+#endif // PHRASETABLEWRITER_H
@@ -0,0 +1,241 @@
+#include "phrasevalidator.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QStringList>
+#include <QtConcurrent/QtConcurrentMap>
+
+#include <algorithm>
+#include <iterator>
+
+namespace {
+enum ByteClass : quint8 {
+    Plain = 0,
+    Percent,
+    Angle,
+    Ampersand
+};
+
+//Built once, the scanner only stops on bytes that can start a token
+struct ByteTable
+{
+    ByteTable()
+    {
+        std::fill(classes, classes + 256, Plain);
+        classes[static_cast<uchar>('%')] = Percent;
+        classes[static_cast<uchar>('<')] = Angle;
+        classes[static_cast<uchar>('&')] = Ampersand;
+    }
+    quint8 classes[256];
+};
+const ByteTable table;
+
+inline bool isAsciiLetter(char c) {return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');}
+inline bool isAsciiDigit(char c) {return c >= '0' && c <= '9';}
+
+//Lead bytes of non ASCII characters count as letters, like QChar::isLetterOrNumber() in Normalizer
+inline bool isAcceleratorKey(char c) {return isAsciiLetter(c) || isAsciiDigit(c) || static_cast<uchar>(c) >= 0xC0;}
+
+QString joined(const QVector<QByteArray> &tokens)
+{
+    QStringList list;
+    for(const QByteArray &token : tokens)
+        list << QString::fromUtf8(token);
+    return list.join(QStringLiteral(", "));
+}
+
+//Difference of two sorted token lists, empty if they are equal
+QString difference(const QVector<QByteArray> &source, const QVector<QByteArray> &target)
+{
+    if(source == target)
+        return QString();
+
+    QVector<QByteArray> missing, unexpected;
+    std::set_difference(source.cbegin(), source.cend(), target.cbegin(), target.cend(), std::back_inserter(missing));
+    std::set_difference(target.cbegin(), target.cend(), source.cbegin(), source.cend(), std::back_inserter(unexpected));
+
+    QStringList parts;
+    if(!missing.isEmpty())
+        parts << QStringLiteral("missing %1").arg(joined(missing));
+    if(!unexpected.isEmpty())
+        parts << QStringLiteral("unexpected %1").arg(joined(unexpected));
+    return parts.join(QStringLiteral("; "));
+}
+
+QString checkName(PhraseValidator::Check check)
+{
+    switch (check) {
+    case PhraseValidator::Placeholders: return QStringLiteral("placeholder");
+    case PhraseValidator::Markup: return QStringLiteral("markup");
+    case PhraseValidator::Accelerators: return QStringLiteral("accelerator");
+    default: return QString();
+    }
+}
+
+struct ValidationChunk
+{
+    int begin = 0;
+    int end = 0;
+    QVector<PhraseValidator::Finding> findings;
+};
+}
+
+PhraseValidator::PhraseValidator(Checks checks) : m_checks(checks)
+{
+
+}
+
+PhraseValidator::Tokens PhraseValidator::scan(const QByteArray &utf8)
+{
+    Tokens tokens;
+    const char *data = utf8.constData();
+    const int size = utf8.size();
+
+    int i(0);
+    while(i < size){
+        const quint8 byteClass = table.classes[static_cast<uchar>(data[i])];
+        if(byteClass == Plain){
+            i++;
+            continue;
+        }
+
+        const int begin = i++;
+        if(byteClass == Percent){
+            if(i < size && data[i] == '%'){
+                //Literal percent sign
+                i++;
+                continue;
+            }
+            if(i < size && data[i] == 'L')
+                i++;
+            if(i < size && data[i] == 'n'){
+                tokens.placeholders << QByteArray(data + begin, i + 1 - begin);
+                i++;
+            } else if(i < size && isAsciiDigit(data[i]) && data[i] != '0'){
+                i++;
+                if(i < size && isAsciiDigit(data[i]))
+                    i++;
+                tokens.placeholders << QByteArray(data + begin, i - begin);
+            }
+        } else if(byteClass == Angle){
+            const bool closing = i < size && data[i] == '/';
+            const int nameBegin = closing ? i + 1 : i;
+            int nameEnd(nameBegin);
+            if(nameEnd < size && isAsciiLetter(data[nameEnd])){
+                while(nameEnd < size && (isAsciiLetter(data[nameEnd]) || isAsciiDigit(data[nameEnd])))
+                    nameEnd++;
+
+                QByteArray name = QByteArray(data + nameBegin, nameEnd - nameBegin).toLower();
+                tokens.tags << (closing ? '/' + name : name);
+                i = nameEnd;
+            }
+        } else {
+            if(i < size && data[i] == '&')
+                i++;
+            else if(i < size && isAcceleratorKey(data[i]))
+                tokens.accelerators++;
+        }
+    }
+
+    std::sort(tokens.placeholders.begin(), tokens.placeholders.end());
+    std::sort(tokens.tags.begin(), tokens.tags.end());
+    return tokens;
+}
+
+QVector<PhraseValidator::Finding> PhraseValidator::check(const Phrase &phrase, const QString &file) const
+{
+    QVector<Finding> findings;
+    if(!phrase.hasTranslation())
+        return findings;
+
+    const Tokens source = scan(phrase.sourceUtf8());
+    const Tokens target = scan(phrase.targetUtf8());
+
+    const auto addFinding = [&findings, &phrase, &file](Check check, const QString &detail){
+        Finding finding;
+        finding.check = check;
+        finding.file = file;
+        finding.definition = phrase.definition();
+        finding.source = phrase.source();
+        finding.target = phrase.target();
+        finding.detail = detail;
+        findings << finding;
+    };
+
+    if(m_checks & Placeholders){
+        const QString detail = difference(source.placeholders, target.placeholders);
+        if(!detail.isEmpty())
+            addFinding(Placeholders, detail);
+    }
+    if(m_checks & Markup){
+        const QString detail = difference(source.tags, target.tags);
+        if(!detail.isEmpty())
+            addFinding(Markup, detail);
+    }
+    if(m_checks & Accelerators && (source.accelerators > 0) != (target.accelerators > 0)){
+        addFinding(Accelerators, source.accelerators > 0 ? QStringLiteral("missing accelerator")
+                                                         : QStringLiteral("unexpected accelerator"));
+    }
+    return findings;
+}
+
+void PhraseValidator::add(const QVector<Phrase> &phrases, const QString &file)
+{
+    const int chunkSize = 4096;
+
+    QVector<ValidationChunk> chunks;
+    for(int begin(0); begin < phrases.size(); begin += chunkSize){
+        ValidationChunk chunk;
+        chunk.begin = begin;
+        chunk.end = qMin(begin + chunkSize, phrases.size());
+        chunks << chunk;
+    }
+
+    const PhraseValidator *validator = this;
+    QtConcurrent::blockingMap(chunks, [validator, &phrases, &file](ValidationChunk &chunk){
+        for(int i(chunk.begin); i < chunk.end; i++)
+            chunk.findings << validator->check(phrases.at(i), file);
+    });
+
+    for(const ValidationChunk &chunk : qAsConst(chunks))
+        m_findings << chunk.findings;
+    m_phrases += phrases.size();
+}
+
+bool PhraseValidator::writeReport(const QString &fileName) const
+{
+    QJsonObject counts;
+    for(Check check : {Placeholders, Markup, Accelerators}){
+        if(m_checks & check)
+            counts.insert(checkName(check), 0);
+    }
+
+    QJsonArray findings;
+    for(const Finding &finding : m_findings){
+        const QString name = checkName(finding.check);
+        counts.insert(name, counts.value(name).toInt() + 1);
+
+        QJsonObject entry;
+        entry.insert("check", name);
+        entry.insert("file", finding.file);
+        entry.insert("definition", finding.definition);
+        entry.insert("source", finding.source);
+        entry.insert("target", finding.target);
+        entry.insert("detail", finding.detail);
+        findings.append(entry);
+    }
+
+    QJsonObject root;
+    root.insert("phrases", m_phrases);
+    root.insert("findingCount", m_findings.size());
+    root.insert("counts", counts);
+    root.insert("findings", findings);
+
+    QSaveFile file(fileName);
+    if(!file.open(QIODevice::WriteOnly))
+        return false;
+    file.write(QJsonDocument(root).toJson());
+    return file.commit();
+}
@@ -0,0 +1,67 @@
+#ifndef PHRASEVALIDATOR_H
+#define PHRASEVALIDATOR_H
+
+#include "phrasebookcore_global.h"
+#include "phrase.h"
+
+#include <QByteArray>
+#include <QFlags>
+#include <QString>
+#include <QVector>
+
+//Checks that translations keep the placeholders, markup and accelerators of their sources.
+//Texts are scanned once on their UTF-8 bytes, the phrases are checked in parallel chunks
+class PHRASEBOOKCORE_EXPORT PhraseValidator
+{
+public:
+    enum Check {
+        NoChecks = 0x0,
+        Placeholders = 0x1,     //%1 - %99, %L1, %n and %Ln, in any order
+        Markup = 0x2,           //Opening and closing tags, by name
+        Accelerators = 0x4,     //&File, && is an escaped ampersand
+        AllChecks = 0x7
+    };
+    Q_DECLARE_FLAGS(Checks, Check)
+
+    struct Finding
+    {
+        Check check = NoChecks;
+        QString file;
+        QString definition;
+        QString source;
+        QString target;
+        QString detail;
+    };
+
+    //Tokens of one text, placeholders and tags are sorted
+    struct Tokens
+    {
+        QVector<QByteArray> placeholders;
+        QVector<QByteArray> tags;
+        int accelerators = 0;
+    };
+
+    explicit PhraseValidator(Checks checks = AllChecks);
+
+    static Tokens scan(const QByteArray &utf8);
+
+    //Empty for phrases without translation
+    QVector<Finding> check(const Phrase &phrase, const QString &file) const;
+
+    //Findings are kept in the order of the phrases
+    void add(const QVector<Phrase> &phrases, const QString &file);
+
+    inline qint64 phraseCount() const {return m_phrases;}
+    inline const QVector<Finding> &findings() const {return m_findings;}
+
+    bool writeReport(const QString &fileName) const;
+
+private:
+    Checks m_checks;
+    qint64 m_phrases = 0;
+    QVector<Finding> m_findings;
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(PhraseValidator::Checks)
+
+#endif // PHRASEVALIDATOR_H
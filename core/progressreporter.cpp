@@ -0,0 +1,64 @@
+#include "progressreporter.h"
+
+#include <limits>
+
+ProgressReporter::ProgressReporter(QObject *parent) : QObject(parent)
+{
+    m_clock.start();
+}
+
+void ProgressReporter::reset()
+{
+    m_total.store(0);
+    m_done.store(0);
+    m_publishedTotal.store(-1);
+    m_lastPublish.store(m_clock.elapsed());
+
+    emit progressMaximum(0);
+    emit progressValue(0);
+}
+
+void ProgressReporter::addToTotal(qint64 bytes)
+{
+    m_total.fetchAndAddOrdered(bytes);
+    publish(false);
+}
+
+void ProgressReporter::advance(qint64 bytes)
+{
+    if(bytes <= 0)
+        return;
+    m_done.fetchAndAddOrdered(bytes);
+    publish(false);
+}
+
+void ProgressReporter::finish()
+{
+    m_done.store(m_total.load());
+    publish(true);
+}
+
+void ProgressReporter::publish(bool force)
+{
+    if(!force){
+        const qint64 now = m_clock.elapsed();
+        const qint64 last = m_lastPublish.load();
+        if(now - last < m_interval)
+            return;
+        //Only one thread gets to publish per interval
+        if(!m_lastPublish.testAndSetOrdered(last, now))
+            return;
+    }
+
+    const qint64 total = m_total.load();
+    const qint64 done = qMin(m_done.load(), total);
+
+    //QProgressBar works with int, scale both values down until they fit
+    int shift(0);
+    while((total >> shift) > std::numeric_limits<int>::max())
+        shift++;
+
+    if(m_publishedTotal.fetchAndStoreOrdered(total) != total)
+        emit progressMaximum(static_cast<int>(total >> shift));
+    emit progressValue(static_cast<int>(done >> shift));
+}
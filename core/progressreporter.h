@@ -0,0 +1,45 @@
+#ifndef PROGRESSREPORTER_H
+#define PROGRESSREPORTER_H
+
+#include "phrasebookcore_global.h"
+
+#include <QAtomicInteger>
+#include <QElapsedTimer>
+#include <QObject>
+
+//Accumulates progress in bytes from any number of threads/jobs and publishes it
+//at a fixed cadence, so the receiving event loop is not flooded with updates
+class PHRASEBOOKCORE_EXPORT ProgressReporter : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ProgressReporter(QObject *parent = nullptr);
+
+    inline void setInterval(int msec){m_interval = msec;}
+
+    //Not thread safe, call before any job is started
+    void reset();
+
+    //Thread safe
+    void addToTotal(qint64 bytes);
+    void advance(qint64 bytes);
+    void finish();
+
+signals:
+    void progressMaximum(int maximum);
+    void progressValue(int value);
+
+private:
+    void publish(bool force);
+
+private:
+    QAtomicInteger<qint64> m_total;
+    QAtomicInteger<qint64> m_done;
+    QAtomicInteger<qint64> m_publishedTotal;
+    QAtomicInteger<qint64> m_lastPublish;
+
+    QElapsedTimer m_clock;
+    int m_interval = 33; //~30 Hz
+};
+
+#endif // PROGRESSREPORTER_H
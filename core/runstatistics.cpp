@@ -0,0 +1,131 @@
+#include "runstatistics.h"
+
+#include <QStringList>
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#include <psapi.h>
+#elif defined(Q_OS_UNIX)
+#include <sys/resource.h>
+#endif
+
+void RunStatistics::clear()
+{
+    *this = RunStatistics();
+    m_runTimer.start();
+}
+
+void RunStatistics::merge(const RunStatistics &other)
+{
+    bytesRead += other.bytesRead;
+    bytesWritten += other.bytesWritten;
+    filesRead += other.filesRead;
+    filesWritten += other.filesWritten;
+    filesSkipped += other.filesSkipped;
+
+    contextsParsed += other.contextsParsed;
+    contextsReused += other.contextsReused;
+    messagesParsed += other.messagesParsed;
+    phrasesParsed += other.phrasesParsed;
+    oldSourceExpansions += other.oldSourceExpansions;
+
+    uniquePhrases += other.uniquePhrases;
+    duplicatesDropped += other.duplicatesDropped;
+    conflictsResolved += other.conflictsResolved;
+
+    patchHits += other.patchHits;
+    patchMisses += other.patchMisses;
+
+    validationFindings += other.validationFindings;
+
+    peakRss = qMax(peakRss, other.peakRss);
+}
+
+void RunStatistics::startPhase(const QString &name)
+{
+    endPhase();
+    m_phase = name;
+    m_phaseTimer.start();
+}
+
+void RunStatistics::endPhase()
+{
+    if(m_phase.isEmpty())
+        return;
+
+    phaseTimes.append(qMakePair(m_phase, m_phaseTimer.elapsed()));
+    m_phase.clear();
+}
+
+void RunStatistics::finish()
+{
+    endPhase();
+    if(m_runTimer.isValid())
+        wallTime = m_runTimer.elapsed();
+    peakRss = currentPeakRss();
+}
+
+double RunStatistics::dedupHitRate() const
+{
+    const qint64 total = uniquePhrases + duplicatesDropped;
+    if(total == 0)
+        return 0.0;
+    return static_cast<double>(duplicatesDropped) / total;
+}
+
+double RunStatistics::throughput() const
+{
+    if(wallTime <= 0)
+        return 0.0;
+    return bytesRead * 1000.0 / wallTime;
+}
+
+QString RunStatistics::toString() const
+{
+    QStringList lines;
+    lines << QString("bytes read:            %1").arg(bytesRead)
+          << QString("bytes written:         %1").arg(bytesWritten)
+          << QString("files read/written:    %1/%2").arg(filesRead).arg(filesWritten)
+          << QString("files skipped:         %1").arg(filesSkipped)
+          << QString("contexts parsed:       %1").arg(contextsParsed)
+          << QString("contexts reused:       %1").arg(contextsReused)
+          << QString("messages parsed:       %1").arg(messagesParsed)
+          << QString("phrases parsed:        %1").arg(phrasesParsed)
+          << QString("oldsource expansions:  %1").arg(oldSourceExpansions)
+          << QString("unique phrases:        %1").arg(uniquePhrases)
+          << QString("duplicates dropped:    %1 (%2 %)").arg(duplicatesDropped).arg(dedupHitRate() * 100.0, 0, 'f', 1)
+          << QString("conflicts resolved:    %1").arg(conflictsResolved)
+          << QString("patch hits/misses:     %1/%2").arg(patchHits).arg(patchMisses)
+          << QString("validation findings:   %1").arg(validationFindings)
+          << QString("wall time:             %1 ms").arg(wallTime)
+          << QString("throughput:            %1 MB/s").arg(throughput() / (1024.0 * 1024.0), 0, 'f', 2)
+          << QString("peak rss:              %1 MB").arg(peakRss / (1024.0 * 1024.0), 0, 'f', 1);
+
+    for(const QPair<QString, qint64> &phase : phaseTimes)
+        lines << QString("  phase %1: %2 ms").arg(phase.first).arg(phase.second);
+
+    return lines.join('\n');
+}
+
+qint64 RunStatistics::currentPeakRss()
+{
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS counters;
+    if(GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return static_cast<qint64>(counters.PeakWorkingSetSize);
+    return 0;
+#elif defined(Q_OS_UNIX)
+    struct rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+#if defined(Q_OS_DARWIN)
+    //macOS reports bytes
+    return static_cast<qint64>(usage.ru_maxrss);
+#else
+    //Linux & BSD report kilobytes
+    return static_cast<qint64>(usage.ru_maxrss) * 1024;
+#endif
+#else
+    return 0;
+#endif
+}
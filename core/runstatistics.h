@@ -0,0 +1,69 @@
+#ifndef RUNSTATISTICS_H
+#define RUNSTATISTICS_H
+
+#include "phrasebookcore_global.h"
+
+#include <QElapsedTimer>
+#include <QMetaType>
+#include <QPair>
+#include <QString>
+#include <QVector>
+
+//Counters collected during one PhrasebookMaker or Merger operation
+struct PHRASEBOOKCORE_EXPORT RunStatistics
+{
+    void clear();
+
+    //Adds the counters of another run, e.g. of a job that ran on a different thread
+    void merge(const RunStatistics &other);
+
+    //Starting a new phase ends the currently running one
+    void startPhase(const QString &name);
+    void endPhase();
+
+    //Ends the last phase, stores total wall time and peak memory usage
+    void finish();
+
+    double dedupHitRate() const;
+    double throughput() const; //bytes read per second
+
+    QString toString() const;
+
+    static qint64 currentPeakRss();
+
+    qint64 bytesRead = 0;
+    qint64 bytesWritten = 0;
+    qint64 filesRead = 0;
+    qint64 filesWritten = 0;
+    qint64 filesSkipped = 0;
+
+    qint64 contextsParsed = 0;
+    qint64 contextsReused = 0;
+    qint64 messagesParsed = 0;
+    qint64 phrasesParsed = 0;
+    qint64 oldSourceExpansions = 0;
+
+    qint64 uniquePhrases = 0;
+    qint64 duplicatesDropped = 0;
+    qint64 conflictsResolved = 0;
+
+    qint64 patchHits = 0;
+    qint64 patchMisses = 0;
+
+    qint64 validationFindings = 0;
+
+    qint64 wallTime = 0;    //ms
+    qint64 peakRss = 0;     //bytes
+
+    //Phase name and wall time in ms, in the order they were run
+    QVector<QPair<QString, qint64>> phaseTimes;
+
+private:
+    QString m_phase;
+    QElapsedTimer m_phaseTimer;
+    QElapsedTimer m_runTimer;
+};
+
+Q_DECLARE_METATYPE(RunStatistics)
+
+#endif // RUNSTATISTICS_H
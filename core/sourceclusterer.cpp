@@ -0,0 +1,285 @@
+#include "sourceclusterer.h"
+#include "normalizer.h"
+#include "parallelsort.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QtConcurrent/QtConcurrentMap>
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+//16 bands of 4 rows, the LSH threshold (1/16)^(1/4) is 0.5
+const int Bands = 16;
+const int Rows = 4;
+
+//Members of one bucket are only compared to the first ones, which keeps huge buckets linear
+const int MaxBucketComparisons = 32;
+
+const int ChunkSize = 4096;
+
+//Ignored while comparing, so "&Save file..." and "Save File" are the same source
+const Normalizer::Steps ShingleNormalization = Normalizer::StripAccelerators | Normalizer::FoldWhitespace
+        | Normalizer::StripTrailingPunctuation | Normalizer::FoldCase;
+
+inline quint64 mix(quint64 x)
+{
+    //splitmix64 finalizer
+    x ^= x >> 30;
+    x *= Q_UINT64_C(0xbf58476d1ce4e5b9);
+    x ^= x >> 27;
+    x *= Q_UINT64_C(0x94d049bb133111eb);
+    x ^= x >> 31;
+    return x;
+}
+
+//Minimum of all permuted shingles for each row of the band, combined into one bucket key
+quint64 bandKey(const QVector<quint32> &shingles, int band)
+{
+    quint64 key = mix(static_cast<quint64>(band) + 1);
+    for(int row(0); row < Rows; row++){
+        const quint64 seed = mix(static_cast<quint64>(band * Rows + row) + 0x9e3779b97f4a7c15);
+        quint64 minimum = std::numeric_limits<quint64>::max();
+        for(quint32 shingle : shingles)
+            minimum = qMin(minimum, mix(shingle ^ seed));
+        key = mix(key ^ minimum);
+    }
+    return key;
+}
+
+template<typename Function>
+void forEachIndex(int size, Function function)
+{
+    QVector<QPair<int, int>> ranges;
+    for(int begin(0); begin < size; begin += ChunkSize)
+        ranges << qMakePair(begin, qMin(begin + ChunkSize, size));
+
+    QtConcurrent::blockingMap(ranges, [&function](const QPair<int, int> &range){
+        for(int i(range.first); i < range.second; i++)
+            function(i);
+    });
+}
+
+//Union find with path halving and union by size
+struct DisjointSets
+{
+    explicit DisjointSets(int size) : parents(size), sizes(size, 1)
+    {
+        for(int i(0); i < size; i++)
+            parents[i] = i;
+    }
+
+    int find(int i)
+    {
+        while(parents.at(i) != i){
+            parents[i] = parents.at(parents.at(i));
+            i = parents.at(i);
+        }
+        return i;
+    }
+
+    void unite(int a, int b)
+    {
+        if(sizes.at(a) < sizes.at(b))
+            std::swap(a, b);
+        parents[b] = a;
+        sizes[a] += sizes.at(b);
+    }
+
+    QVector<int> parents;
+    QVector<int> sizes;
+};
+
+bool moreRepresentative(const SourceClusterer::Member &a, const SourceClusterer::Member &b)
+{
+    if(a.count != b.count)
+        return a.count > b.count;
+    if(a.source.size() != b.source.size())
+        return a.source.size() < b.source.size();
+    return a.source < b.source;
+}
+}
+
+SourceClusterer::SourceClusterer(double threshold) : m_threshold(threshold)
+{
+
+}
+
+void SourceClusterer::add(const Phrase &phrase)
+{
+    if(phrase.sourceUtf8().isEmpty())
+        return;
+
+    const QString source = phrase.source();
+    auto index = m_indexes.constFind(source);
+    if(index == m_indexes.constEnd()){
+        index = m_indexes.insert(source, m_members.size());
+        Member member;
+        member.source = source;
+        m_members << member;
+    }
+
+    Member &member = m_members[index.value()];
+    member.count++;
+    if(member.target.isEmpty() && phrase.hasTranslation())
+        member.target = phrase.target();
+}
+
+QVector<quint32> SourceClusterer::shingles(const QString &source)
+{
+    const QString text = QLatin1Char(' ') + Normalizer::normalized(source, ShingleNormalization) + QLatin1Char(' ');
+
+    QVector<quint32> hashes;
+    hashes.reserve(text.size());
+    for(int i(0); i + 3 <= text.size(); i++){
+        const quint64 trigram = (static_cast<quint64>(text.at(i).unicode()) << 32)
+                | (static_cast<quint64>(text.at(i + 1).unicode()) << 16)
+                | text.at(i + 2).unicode();
+        hashes << static_cast<quint32>(mix(trigram));
+    }
+
+    std::sort(hashes.begin(), hashes.end());
+    hashes.erase(std::unique(hashes.begin(), hashes.end()), hashes.end());
+    return hashes;
+}
+
+double SourceClusterer::similarity(const QVector<quint32> &shinglesA, const QVector<quint32> &shinglesB)
+{
+    //Sources without text, e.g. "..." or "&", are not similar to anything
+    if(shinglesA.isEmpty() || shinglesB.isEmpty())
+        return 0.0;
+
+    //Both are sorted, one merge pass
+    int a(0), b(0), shared(0);
+    while(a < shinglesA.size() && b < shinglesB.size()){
+        if(shinglesA.at(a) < shinglesB.at(b)){
+            a++;
+        } else if(shinglesB.at(b) < shinglesA.at(a)){
+            b++;
+        } else {
+            shared++;
+            a++;
+            b++;
+        }
+    }
+    return static_cast<double>(shared) / (shinglesA.size() + shinglesB.size() - shared);
+}
+
+QVector<SourceClusterer::Cluster> SourceClusterer::clusters() const
+{
+    const int size = m_members.size();
+
+    QVector<QVector<quint32>> shingleSets(size);
+    forEachIndex(size, [this, &shingleSets](int i){
+        shingleSets[i] = shingles(m_members.at(i).source);
+    });
+
+    //One band at a time, only the bucket keys of a single band are kept
+    DisjointSets sets(size);
+    QVector<QPair<quint64, int>> buckets(size);
+    for(int band(0); band < Bands; band++){
+        forEachIndex(size, [&shingleSets, &buckets, band](int i){
+            buckets[i] = qMakePair(bandKey(shingleSets.at(i), band), i);
+        });
+        parallelSort(buckets, [](const QPair<quint64, int> &a, const QPair<quint64, int> &b){ return a < b; });
+
+        int begin(0);
+        while(begin < size){
+            int end(begin + 1);
+            while(end < size && buckets.at(end).first == buckets.at(begin).first)
+                end++;
+
+            for(int i(begin + 1); i < end; i++){
+                const int b = buckets.at(i).second;
+                for(int j(begin); j < qMin(i, begin + MaxBucketComparisons); j++){
+                    const int a = buckets.at(j).second;
+                    const int rootA = sets.find(a);
+                    const int rootB = sets.find(b);
+                    if(rootA == rootB)
+                        continue;
+
+                    //A Jaccard similarity above the threshold needs sets of similar size
+                    const int smaller = qMin(shingleSets.at(a).size(), shingleSets.at(b).size());
+                    const int larger = qMax(shingleSets.at(a).size(), shingleSets.at(b).size());
+                    if(smaller < m_threshold * larger)
+                        continue;
+
+                    if(similarity(shingleSets.at(a), shingleSets.at(b)) >= m_threshold)
+                        sets.unite(rootA, rootB);
+                }
+            }
+            begin = end;
+        }
+    }
+
+    QHash<int, int> clusterOfRoot;
+    QVector<Cluster> clusters;
+    for(int i(0); i < size; i++){
+        const int root = sets.find(i);
+        if(sets.sizes.at(root) < 2)
+            continue;
+
+        auto cluster = clusterOfRoot.constFind(root);
+        if(cluster == clusterOfRoot.constEnd()){
+            cluster = clusterOfRoot.insert(root, clusters.size());
+            clusters << Cluster();
+        }
+        clusters[cluster.value()].members << m_members.at(i);
+        clusters[cluster.value()].occurrences += m_members.at(i).count;
+    }
+
+    //The most frequent source is suggested as canonical entry and listed first
+    for(Cluster &cluster : clusters){
+        std::sort(cluster.members.begin(), cluster.members.end(), moreRepresentative);
+        cluster.canonical = 0;
+    }
+    std::sort(clusters.begin(), clusters.end(), [](const Cluster &a, const Cluster &b){
+        if(a.occurrences != b.occurrences)
+            return a.occurrences > b.occurrences;
+        return a.members.first().source < b.members.first().source;
+    });
+    return clusters;
+}
+
+bool SourceClusterer::writeReport(const QString &fileName) const
+{
+    const QVector<Cluster> found = clusters();
+
+    QJsonArray clusters;
+    for(const Cluster &cluster : found){
+        const Member &canonical = cluster.members.at(cluster.canonical);
+        const QVector<quint32> canonicalShingles = shingles(canonical.source);
+
+        QJsonArray members;
+        for(const Member &member : cluster.members){
+            QJsonObject entry;
+            entry.insert("source", member.source);
+            entry.insert("target", member.target);
+            entry.insert("count", member.count);
+            entry.insert("similarity", similarity(canonicalShingles, shingles(member.source)));
+            members.append(entry);
+        }
+
+        QJsonObject entry;
+        entry.insert("canonical", canonical.source);
+        entry.insert("target", canonical.target);
+        entry.insert("occurrences", cluster.occurrences);
+        entry.insert("members", members);
+        clusters.append(entry);
+    }
+
+    QJsonObject root;
+    root.insert("threshold", m_threshold);
+    root.insert("sources", m_members.size());
+    root.insert("clusterCount", found.size());
+    root.insert("clusters", clusters);
+
+    QSaveFile file(fileName);
+    if(!file.open(QIODevice::WriteOnly))
+        return false;
+    file.write(QJsonDocument(root).toJson());
+    return file.commit();
+}
@@ -0,0 +1,55 @@
+#ifndef SOURCECLUSTERER_H
+#define SOURCECLUSTERER_H
+
+#include "phrasebookcore_global.h"
+#include "phrase.h"
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+//Groups near identical sources ("Save file", "Save file...", "Save the file") without comparing every pair.
+//Sources are shingled into character trigrams, MinHash signatures are bucketed band by band (LSH) and
+//only sources sharing a bucket are compared, by the exact Jaccard similarity of their trigram sets
+class PHRASEBOOKCORE_EXPORT SourceClusterer
+{
+public:
+    struct Member
+    {
+        QString source;
+        QString target;     //First translation seen
+        qint64 count = 0;
+    };
+
+    struct Cluster
+    {
+        int canonical = 0;  //Index into members, the most frequent source
+        qint64 occurrences = 0;
+        QVector<Member> members;
+    };
+
+    //Similar sources share a bucket in at least one of 16 bands with a probability of ~90% at 0.6
+    explicit SourceClusterer(double threshold = 0.6);
+
+    //Equal sources are only counted
+    void add(const Phrase &phrase);
+
+    inline int sourceCount() const {return m_members.size();}
+
+    //Clusters with at least two sources, most occurrences first
+    QVector<Cluster> clusters() const;
+
+    static double similarity(const QVector<quint32> &shinglesA, const QVector<quint32> &shinglesB);
+    //Sorted, unique trigram hashes of the normalized source
+    static QVector<quint32> shingles(const QString &source);
+
+    bool writeReport(const QString &fileName) const;
+
+private:
+    double m_threshold;
+
+    QHash<QString, int> m_indexes;
+    QVector<Member> m_members;
+};
+
+#endif // SOURCECLUSTERER_H
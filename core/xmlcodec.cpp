@@ -0,0 +1,243 @@
+#include "xmlcodec.h"
+
+#include <QtAlgorithms>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define XMLCODEC_SSE2
+#endif
+
+namespace {
+const ushort EscapedCharacters[] = {'&', '<', '>', '"'};
+const ushort EntityStart[] = {'&'};
+const char EscapedBytes[] = {'&', '<', '>', '"'};
+const char EntityStartByte[] = {'&'};
+
+//Index of the first of the given characters, -1 if there is none. SSE2 compares 8 characters at once
+template<int Count>
+int indexOfAny(const QChar *text, int size, const ushort (&characters)[Count])
+{
+    const ushort *data = reinterpret_cast<const ushort *>(text);
+    int i(0);
+
+#ifdef XMLCODEC_SSE2
+    __m128i needles[Count];
+    for(int c(0); c < Count; c++)
+        needles[c] = _mm_set1_epi16(static_cast<short>(characters[c]));
+
+    for(; i + 8 <= size; i += 8){
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        __m128i matches = _mm_cmpeq_epi16(block, needles[0]);
+        for(int c(1); c < Count; c++)
+            matches = _mm_or_si128(matches, _mm_cmpeq_epi16(block, needles[c]));
+
+        const uint mask = static_cast<uint>(_mm_movemask_epi8(matches));
+        if(mask)
+            return i + static_cast<int>(qCountTrailingZeroBits(mask)) / 2;
+    }
+#endif
+
+    for(; i < size; i++){
+        for(int c(0); c < Count; c++){
+            if(data[i] == characters[c])
+                return i;
+        }
+    }
+    return -1;
+}
+
+//Same for UTF-8, 16 bytes at once. Only ASCII is searched, so continuation bytes never match
+template<int Count>
+int indexOfAny(const char *data, int size, const char (&characters)[Count])
+{
+    int i(0);
+
+#ifdef XMLCODEC_SSE2
+    __m128i needles[Count];
+    for(int c(0); c < Count; c++)
+        needles[c] = _mm_set1_epi8(characters[c]);
+
+    for(; i + 16 <= size; i += 16){
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        __m128i matches = _mm_cmpeq_epi8(block, needles[0]);
+        for(int c(1); c < Count; c++)
+            matches = _mm_or_si128(matches, _mm_cmpeq_epi8(block, needles[c]));
+
+        const uint mask = static_cast<uint>(_mm_movemask_epi8(matches));
+        if(mask)
+            return i + static_cast<int>(qCountTrailingZeroBits(mask));
+    }
+#endif
+
+    for(; i < size; i++){
+        for(int c(0); c < Count; c++){
+            if(data[i] == characters[c])
+                return i;
+        }
+    }
+    return -1;
+}
+
+QByteArray entityBytes(const QByteArray &entity, bool *ok)
+{
+    *ok = true;
+    if(entity == "lt")
+        return QByteArrayLiteral("<");
+    if(entity == "gt")
+        return QByteArrayLiteral(">");
+    if(entity == "amp")
+        return QByteArrayLiteral("&");
+    if(entity == "quot")
+        return QByteArrayLiteral("\"");
+    if(entity == "apos")
+        return QByteArrayLiteral("'");
+    if(entity.startsWith('#')){
+        const uint code = entity.startsWith("#x") ? entity.mid(2).toUInt(ok, 16) : entity.mid(1).toUInt(ok, 10);
+        if(*ok)
+            return QString::fromUcs4(&code, 1).toUtf8();
+        return QByteArray();
+    }
+    *ok = false;
+    return QByteArray();
+}
+}
+
+QString XmlCodec::escaped(const QString &text)
+{
+    int next = indexOfAny(text.constData(), text.size(), EscapedCharacters);
+    if(next < 0)
+        return text;
+
+    QString xml;
+    xml.reserve(text.size() + 16);
+    int copied(0);
+    while(next >= 0){
+        xml.append(text.constData() + copied, next - copied);
+        switch(text.at(next).unicode()){
+        case '&': xml.append(QLatin1String("&amp;")); break;
+        case '<': xml.append(QLatin1String("&lt;")); break;
+        case '>': xml.append(QLatin1String("&gt;")); break;
+        default: xml.append(QLatin1String("&quot;")); break;
+        }
+
+        copied = next + 1;
+        const int found = indexOfAny(text.constData() + copied, text.size() - copied, EscapedCharacters);
+        next = found < 0 ? -1 : copied + found;
+    }
+    xml.append(text.constData() + copied, text.size() - copied);
+    return xml;
+}
+
+QByteArray XmlCodec::escaped(const QByteArray &utf8)
+{
+    int next = indexOfAny(utf8.constData(), utf8.size(), EscapedBytes);
+    if(next < 0)
+        return utf8;
+
+    QByteArray xml;
+    xml.reserve(utf8.size() + 16);
+    int copied(0);
+    while(next >= 0){
+        xml.append(utf8.constData() + copied, next - copied);
+        switch(utf8.at(next)){
+        case '&': xml.append("&amp;"); break;
+        case '<': xml.append("&lt;"); break;
+        case '>': xml.append("&gt;"); break;
+        default: xml.append("&quot;"); break;
+        }
+
+        copied = next + 1;
+        const int found = indexOfAny(utf8.constData() + copied, utf8.size() - copied, EscapedBytes);
+        next = found < 0 ? -1 : copied + found;
+    }
+    xml.append(utf8.constData() + copied, utf8.size() - copied);
+    return xml;
+}
+
+QByteArray XmlCodec::unescaped(const QByteArray &utf8)
+{
+    int next = indexOfAny(utf8.constData(), utf8.size(), EntityStartByte);
+    if(next < 0)
+        return utf8;
+
+    QByteArray plain;
+    plain.reserve(utf8.size());
+    int copied(0);
+    while(next >= 0){
+        plain.append(utf8.constData() + copied, next - copied);
+        copied = next + 1;
+
+        const int end = utf8.indexOf(';', next);
+        bool ok(false);
+        const QByteArray decoded = end < 0 ? QByteArray() : entityBytes(utf8.mid(next + 1, end - next - 1), &ok);
+        if(ok){
+            plain.append(decoded);
+            copied = end + 1;
+        } else {
+            plain.append('&');
+        }
+
+        const int found = indexOfAny(utf8.constData() + copied, utf8.size() - copied, EntityStartByte);
+        next = found < 0 ? -1 : copied + found;
+    }
+    plain.append(utf8.constData() + copied, utf8.size() - copied);
+    return plain;
+}
+
+QString XmlCodec::unescaped(const QString &xml)
+{
+    const int first = indexOfAny(xml.constData(), xml.size(), EntityStart);
+    if(first < 0)
+        return xml;
+    return decode(QStringRef(&xml), first);
+}
+
+QString XmlCodec::unescaped(const QStringRef &xml)
+{
+    const int first = indexOfAny(xml.constData(), xml.size(), EntityStart);
+    if(first < 0)
+        return xml.toString();
+    return decode(xml, first);
+}
+
+QString XmlCodec::decode(const QStringRef &xml, int first)
+{
+    QString plain;
+    plain.reserve(xml.size());
+    plain.append(xml.constData(), first);
+
+    for(int i(first); i < xml.size(); i++){
+        const QChar c = xml.at(i);
+        const int end = c == QChar('&') ? xml.indexOf(QChar(';'), i) : -1;
+        if(end < 0){
+            plain.append(c);
+            continue;
+        }
+
+        const QStringRef entity = xml.mid(i + 1, end - i - 1);
+        if(entity == QLatin1String("lt")){
+            plain.append(QChar('<'));
+        } else if(entity == QLatin1String("gt")){
+            plain.append(QChar('>'));
+        } else if(entity == QLatin1String("amp")){
+            plain.append(QChar('&'));
+        } else if(entity == QLatin1String("quot")){
+            plain.append(QChar('"'));
+        } else if(entity == QLatin1String("apos")){
+            plain.append(QChar('\''));
+        } else if(entity.startsWith(QChar('#'))){
+            bool ok(false);
+            const uint code = entity.startsWith(QLatin1String("#x")) ? entity.mid(2).toUInt(&ok, 16) : entity.mid(1).toUInt(&ok, 10);
+            if(!ok){
+                plain.append(c);
+                continue;
+            }
+            plain.append(QString::fromUcs4(&code, 1));
+        } else {
+            plain.append(c);
+            continue;
+        }
+        i = end;
+    }
+    return plain;
+}
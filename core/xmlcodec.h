@@ -0,0 +1,28 @@
+#ifndef XMLCODEC_H
+#define XMLCODEC_H
+
+#include "phrasebookcore_global.h"
+
+#include <QByteArray>
+#include <QString>
+#include <QStringRef>
+
+//Entity escaping of element text. Phrases hold the plain text, it is decoded while parsing
+//and encoded while writing. Text without special characters is returned as is, without a copy
+class PHRASEBOOKCORE_EXPORT XmlCodec
+{
+public:
+    //&, <, > and "
+    static QString escaped(const QString &text);
+    static QByteArray escaped(const QByteArray &utf8);
+
+    //Predefined and numeric character references, unknown entities are kept as is
+    static QString unescaped(const QString &xml);
+    static QString unescaped(const QStringRef &xml);
+    static QByteArray unescaped(const QByteArray &utf8);
+
+private:
+    static QString decode(const QStringRef &xml, int first);
+};
+
+#endif // XMLCODEC_H